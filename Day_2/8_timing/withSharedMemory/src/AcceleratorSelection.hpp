@@ -0,0 +1,196 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+#include <alpaka/example/ExecuteForEachAccTag.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+//! Runtime selection of the accelerator of an example
+//!
+//! The table of selectable accelerators is alpaka::EnabledAccTags, the tags enabled in the CMake configuration. An
+//! accelerator is selected by the name of its tag, with or without the Tag prefix (TagCpuSerial or CpuSerial), from
+//!   - the command line: --accelerator <name>
+//!   - the environment: HEAT_EQUATION_ACCELERATOR=<name>
+//! where the command line wins. Without a selection the example runs once for each enabled accelerator, as
+//! alpaka::executeForEachAccTag does. --list-accelerators prints the devices and their properties for every enabled
+//! accelerator and runs nothing. Examples on two accelerators select them as a pair, --accelerator <first>,<second>.
+
+//! Whether name selects the accelerator tag TAccTag
+template<typename TAccTag>
+auto matchesAccTag(std::string_view const name) -> bool
+{
+    std::string const tagName = TAccTag::get_name();
+    return name == tagName || (tagName.rfind("Tag", 0) == 0 && name == std::string_view(tagName).substr(3));
+}
+
+//! Prints the devices of the accelerator tag TAccTag and their properties for a 2D kernel
+template<typename TAccTag>
+auto listAccTag(TAccTag const&) -> void
+{
+    using Acc = alpaka::TagToAcc<TAccTag, alpaka::DimInt<2u>, uint32_t>;
+    auto const platformAcc = alpaka::Platform<Acc>{};
+    auto const numDevices = alpaka::getDevCount(platformAcc);
+    std::cout << TAccTag::get_name() << " (" << alpaka::getAccName<Acc>() << "): " << numDevices << " device(s)"
+              << std::endl;
+    for(std::size_t i = 0; i < numDevices; ++i)
+    {
+        auto const devAcc = alpaka::getDevByIdx(platformAcc, i);
+        auto const props = alpaka::getAccDevProps<Acc>(devAcc);
+        std::cout << "  [" << i << "] " << alpaka::getName(devAcc) << ", " << (alpaka::getMemBytes(devAcc) >> 20)
+                  << " MiB global memory, " << props.m_multiProcessorCount << " multiprocessors, "
+                  << props.m_blockThreadCountMax << " threads per block, " << (props.m_sharedMemSizeBytes >> 10)
+                  << " KiB shared memory per block" << std::endl;
+    }
+}
+
+//! Prints the enabled accelerator tags after the unknown name of an accelerator
+inline auto reportUnknownAccTag(std::string_view const name) -> void
+{
+    std::cerr << "Accelerator " << name << " is not enabled, choose one of:";
+    std::apply([](auto const&... tags) { ((std::cerr << ' ' << tags.get_name()), ...); }, alpaka::EnabledAccTags{});
+    std::cerr << "\n";
+}
+
+//! Reads the selection of the accelerator from the environment and the command line
+//!
+//! \param argc argument count of main
+//! \param argv arguments of main
+//! \param usage the selection in the usage message, e.g. <name>
+//! \param selected the selected name, empty without a selection
+//! \return the exit code if main is done, after --list-accelerators or for an unknown argument
+inline auto readAccSelection(
+    int const argc,
+    char const* const* const argv,
+    std::string_view const usage,
+    std::string_view& selected) -> std::optional<int>
+{
+    if(char const* const environment = std::getenv("HEAT_EQUATION_ACCELERATOR"))
+        selected = environment;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string_view const argument = argv[i];
+        if(argument == "--list-accelerators")
+        {
+            std::apply([](auto const&... tags) { (listAccTag(tags), ...); }, alpaka::EnabledAccTags{});
+            return EXIT_SUCCESS;
+        }
+        else if(argument == "--accelerator" && i + 1 < argc)
+        {
+            selected = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--accelerator " << usage << "] [--list-accelerators]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    return std::nullopt;
+}
+
+//! Runs callable(tag) with the tag of the enabled accelerator the name selects
+//!
+//! \return the result of callable, EXIT_FAILURE for an unknown name
+template<typename TCallable>
+auto executeForNamedAccTag(std::string_view const name, TCallable&& callable) -> int
+{
+    // dispatch through the table of enabled tags, at most one of them matches
+    bool found = false;
+    int result = EXIT_FAILURE;
+    auto runIfSelected = [&](auto const& tag)
+    {
+        if(!found && matchesAccTag<std::decay_t<decltype(tag)>>(name))
+        {
+            found = true;
+            result = callable(tag);
+        }
+    };
+    std::apply([&](auto const&... tags) { (runIfSelected(tags), ...); }, alpaka::EnabledAccTags{});
+
+    if(!found)
+        reportUnknownAccTag(name);
+    return result;
+}
+
+//! Runs callable(tag) for the accelerator selected on the command line or in the environment
+//!
+//! \param argc argument count of main
+//! \param argv arguments of main
+//! \param callable the example, called with the tag of the selected accelerator
+//! \return the result of the example, EXIT_FAILURE for an unknown accelerator or argument
+template<typename TCallable>
+auto executeForSelectedAccTag(int const argc, char const* const* const argv, TCallable&& callable) -> int
+{
+    std::string_view selected;
+    if(auto const exitCode = readAccSelection(argc, argv, "<name>", selected))
+        return *exitCode;
+
+    if(selected.empty())
+        return alpaka::executeForEachAccTag(callable);
+    return executeForNamedAccTag(selected, callable);
+}
+
+//! Runs callable(tagFirst, tagSecond) for the pair of accelerators selected on the command line or in the environment
+//!
+//! The pair is selected as <first>,<second>, both may name the same accelerator. Without a selection it is the first
+//! and the last enabled accelerator, which requires at least two enabled accelerators.
+//!
+//! \param argc argument count of main
+//! \param argv arguments of main
+//! \param callable the example, called with the tags of the selected accelerators
+//! \return the result of the example, EXIT_FAILURE for an unknown accelerator or argument
+template<typename TCallable>
+auto executeForSelectedAccTagPair(int const argc, char const* const* const argv, TCallable&& callable) -> int
+{
+    std::string_view selected;
+    if(auto const exitCode = readAccSelection(argc, argv, "<first>,<second>", selected))
+        return *exitCode;
+
+    if(selected.empty())
+    {
+        // the branches depend on the tags, so the pair is not instantiated with less than two enabled accelerators
+        return std::apply(
+            [&](auto const&... tags) -> int
+            {
+                if constexpr(sizeof...(tags) < 2u)
+                {
+                    std::cerr << "Less than two accelerators are enabled, enable a second one or select a pair with "
+                                 "--accelerator <first>,<second>\n";
+                    return EXIT_FAILURE;
+                }
+                else
+                {
+                    auto const enabledTags = std::make_tuple(tags...);
+                    return callable(std::get<0>(enabledTags), std::get<sizeof...(tags) - 1>(enabledTags));
+                }
+            },
+            alpaka::EnabledAccTags{});
+    }
+
+    auto const comma = selected.find(',');
+    if(comma == std::string_view::npos)
+    {
+        std::cerr << "Select two accelerators with --accelerator <first>,<second>, not " << selected << "\n";
+        return EXIT_FAILURE;
+    }
+    auto const nameSecond = selected.substr(comma + 1);
+    return executeForNamedAccTag(
+        selected.substr(0, comma),
+        [&](auto const& tagFirst)
+        {
+            return executeForNamedAccTag(
+                nameSecond,
+                [&](auto const& tagSecond) { return callable(tagFirst, tagSecond); });
+        });
+}
@@ -0,0 +1,299 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "AdaptiveMeshRefinementKernels.hpp"
+#include "StencilKernel.hpp"
+#include "analyticalSolution.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+//! Block-structured adaptive mesh refinement with one fine level
+//!
+//! The chunks of the coarse grid are the candidates for refinement. A chunk whose largest gradient magnitude exceeds
+//! the threshold gets a patch with the refinement ratio two, its own pair of buffers with a halo of one cell. Every
+//! patch is advanced with the same StencilKernel as the coarse grid:
+//!   - the coarse grid is advanced first, then every patch takes four substeps of dt / 4 (the explicit scheme needs
+//!     the time step to shrink with h^2)
+//!   - before every substep the halo of the patch is interpolated from the coarse grid, cubic in space and linear in
+//!     time between the beginning and the end of the coarse step
+//!   - after the substeps the patch values are injected into the coarse cells it covers
+//! regrid re-evaluates the criterion, new patches are interpolated from the coarse grid and patches of chunks that no
+//! longer need refinement are dropped. Patches do not exchange halos with each other, their halos always come from the
+//! coarse grid.
+//!
+//! Only the five-point stencil is supported, the interpolation assumes a halo of one cell.
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_SharedMemSize1D size of the shared memory box of the StencilKernel
+//! \tparam T_BlockSize1D maximum number of threads in a block, used for the refinement criterion
+template<typename TAcc, size_t T_SharedMemSize1D, size_t T_BlockSize1D>
+class AdaptiveMeshRefinement
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using BufAcc = alpaka::Buf<DevAcc, double, Dim, Idx>;
+    using WorkDiv = alpaka::WorkDivMembers<Dim, Idx>;
+
+    //! Refinement ratio in space, the time step of the patches is refined by its square
+    static constexpr Idx refinementRatio = 2;
+    static constexpr Idx numSubsteps = refinementRatio * refinementRatio;
+
+    //! \param devAcc device the patches are allocated on
+    //! \param workDivCore work division of the coarse grid with one block per chunk
+    //! \param numChunks number of chunks of the coarse grid in {Y, X}
+    //! \param chunkSize size of the chunk handled by one block, on both levels
+    //! \param haloSize size of the halo in {Y, X}, has to be one
+    //! \param dx step in x on the coarse grid
+    //! \param dy step in y on the coarse grid
+    //! \param dt step in t on the coarse grid
+    //! \param threshold gradient magnitude above which a chunk is refined
+    AdaptiveMeshRefinement(
+        DevAcc const& devAcc,
+        WorkDiv const& workDivCore,
+        alpaka::Vec<Dim, Idx> const& numChunks,
+        alpaka::Vec<Dim, Idx> const& chunkSize,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt,
+        double const threshold)
+        : m_devAcc(devAcc)
+        , m_flagsAcc(alpaka::allocBuf<uint32_t, Idx>(devAcc, numChunks.prod()))
+        , m_flagsHost(alpaka::allocBuf<uint32_t, Idx>(alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0), numChunks.prod()))
+        , m_numChunks(numChunks)
+        , m_chunkSize(chunkSize)
+        , m_haloSize(haloSize)
+        , m_fineExtent(chunkSize * alpaka::Vec<Dim, Idx>::all(refinementRatio) + haloSize + haloSize)
+        , m_dx(dx)
+        , m_dy(dy)
+        , m_dt(dt)
+        , m_threshold(threshold)
+        , m_workDivCore(workDivCore)
+        // the patch covers refinementRatio^2 fine chunks, the blocks keep the threads of the coarse grid
+        , m_workDivFine(
+              alpaka::Vec<Dim, Idx>::all(refinementRatio),
+              alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(workDivCore),
+              alpaka::Vec<Dim, Idx>::ones())
+        , m_workDivPatch(makeWorkDivPatch(devAcc))
+        , m_workDivInjection(makeWorkDivInjection(devAcc))
+    {
+    }
+
+    //! Creates and drops patches according to the refinement criterion on the coarse values uBuf
+    template<typename TQueue>
+    auto regrid(TQueue& queue, BufAcc& uBuf) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            m_refinementFlagKernel,
+            alpaka::experimental::getMdSpan(uBuf),
+            alpaka::getPtrNative(m_flagsAcc),
+            m_chunkSize,
+            m_haloSize,
+            m_dx,
+            m_dy,
+            m_threshold);
+        alpaka::memcpy(queue, m_flagsHost, m_flagsAcc);
+        alpaka::wait(queue);
+
+        uint32_t const* const flags = alpaka::getPtrNative(m_flagsHost);
+        for(Idx chunk = 0; chunk < m_numChunks.prod(); ++chunk)
+        {
+            auto patch = m_patches.find(chunk);
+            if(flags[chunk] != 0 && patch == m_patches.end())
+            {
+                patch = m_patches
+                            .emplace(
+                                chunk,
+                                Patch{
+                                    alpaka::allocBuf<double, Idx>(m_devAcc, m_fineExtent),
+                                    alpaka::allocBuf<double, Idx>(m_devAcc, m_fineExtent)})
+                            .first;
+                interpolate(queue, uBuf, uBuf, patch->second.uCurrBuf, coarseOrigin(chunk), 0.0, false);
+            }
+            else if(flags[chunk] == 0 && patch != m_patches.end())
+            {
+                m_patches.erase(patch);
+            }
+        }
+        m_maxNumPatches = std::max(m_maxNumPatches, static_cast<Idx>(m_patches.size()));
+    }
+
+    //! Advances all patches by one coarse time step and injects them into the coarse grid
+    //!
+    //! \param uCurrBuf coarse values at the beginning of the step
+    //! \param uNextBuf coarse values at the end of the step including the boundaries, the covered cells are replaced
+    template<typename TQueue>
+    auto step(TQueue& queue, BufAcc& uCurrBuf, BufAcc& uNextBuf) -> void
+    {
+        for(auto& [chunk, patch] : m_patches)
+        {
+            auto const origin = coarseOrigin(chunk);
+            for(Idx substep = 0; substep < numSubsteps; ++substep)
+            {
+                double const alpha = static_cast<double>(substep) / numSubsteps;
+                interpolate(queue, uCurrBuf, uNextBuf, patch.uCurrBuf, origin, alpha, true);
+                alpaka::exec<TAcc>(
+                    queue,
+                    m_workDivFine,
+                    m_stencilKernel,
+                    alpaka::experimental::getMdSpan(patch.uCurrBuf),
+                    alpaka::experimental::getMdSpan(patch.uNextBuf),
+                    m_chunkSize,
+                    m_haloSize,
+                    m_dx / refinementRatio,
+                    m_dy / refinementRatio,
+                    m_dt / numSubsteps);
+                std::swap(patch.uCurrBuf, patch.uNextBuf);
+            }
+            alpaka::exec<TAcc>(
+                queue,
+                m_workDivInjection,
+                m_patchInjectionKernel,
+                alpaka::experimental::getMdSpan(patch.uCurrBuf),
+                alpaka::experimental::getMdSpan(uNextBuf),
+                origin);
+        }
+    }
+
+    //! Largest error of the core cells of all patches to the analytical solution at time t
+    template<typename TQueue>
+    auto maxPatchError(TQueue& queue, double const t) -> double
+    {
+        auto const devHost = alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0);
+        auto uBufHost = alpaka::allocBuf<double, Idx>(devHost, m_fineExtent);
+        double const* const uHost = alpaka::getPtrNative(uBufHost);
+        double maxError = 0.0;
+        for(auto& [chunk, patch] : m_patches)
+        {
+            alpaka::memcpy(queue, uBufHost, patch.uCurrBuf);
+            alpaka::wait(queue);
+            auto const origin = coarseOrigin(chunk);
+            for(Idx j = 1; j < m_fineExtent[0] - 1; ++j)
+            {
+                for(Idx i = 1; i < m_fineExtent[1] - 1; ++i)
+                {
+                    double const x = (2.0 * origin[1] - 1.0 + i) * m_dx / refinementRatio;
+                    double const y = (2.0 * origin[0] - 1.0 + j) * m_dy / refinementRatio;
+                    double const error = std::abs(uHost[j * m_fineExtent[1] + i] - analyticalSolution(x, y, t));
+                    maxError = std::max(maxError, error);
+                }
+            }
+        }
+        return maxError;
+    }
+
+    auto numPatches() const -> Idx
+    {
+        return static_cast<Idx>(m_patches.size());
+    }
+
+    auto maxNumPatches() const -> Idx
+    {
+        return m_maxNumPatches;
+    }
+
+private:
+    struct Patch
+    {
+        BufAcc uCurrBuf;
+        BufAcc uNextBuf;
+    };
+
+    //! First coarse core cell covered by the patch of the chunk, as index of the coarse buffer
+    auto coarseOrigin(Idx const chunk) const -> alpaka::Vec<Dim, Idx>
+    {
+        auto const chunkIdx = alpaka::Vec<Dim, Idx>{chunk / m_numChunks[1], chunk % m_numChunks[1]};
+        return chunkIdx * m_chunkSize + m_haloSize;
+    }
+
+    template<typename TQueue>
+    auto interpolate(
+        TQueue& queue,
+        BufAcc& coarseOldBuf,
+        BufAcc& coarseNewBuf,
+        BufAcc& fineBuf,
+        alpaka::Vec<Dim, Idx> const& origin,
+        double const alpha,
+        bool const haloOnly) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivPatch,
+            m_patchInterpolationKernel,
+            alpaka::experimental::getMdSpan(coarseOldBuf),
+            alpaka::experimental::getMdSpan(coarseNewBuf),
+            alpaka::experimental::getMdSpan(fineBuf),
+            origin,
+            alpha,
+            haloOnly);
+    }
+
+    //! One thread per cell of a patch including its halo
+    auto makeWorkDivPatch(DevAcc const& devAcc) -> WorkDiv
+    {
+        auto fineBuf = alpaka::allocBuf<double, Idx>(devAcc, m_fineExtent);
+        alpaka::KernelCfg<TAcc> const cfgPatch = {m_fineExtent, alpaka::Vec<Dim, Idx>::ones()};
+        return alpaka::getValidWorkDiv(
+            cfgPatch,
+            devAcc,
+            m_patchInterpolationKernel,
+            alpaka::experimental::getMdSpan(fineBuf),
+            alpaka::experimental::getMdSpan(fineBuf),
+            alpaka::experimental::getMdSpan(fineBuf),
+            m_haloSize,
+            0.0,
+            false);
+    }
+
+    //! One thread per coarse cell covered by a patch
+    auto makeWorkDivInjection(DevAcc const& devAcc) -> WorkDiv
+    {
+        auto fineBuf = alpaka::allocBuf<double, Idx>(devAcc, m_fineExtent);
+        alpaka::KernelCfg<TAcc> const cfgInjection = {m_chunkSize, alpaka::Vec<Dim, Idx>::ones()};
+        return alpaka::getValidWorkDiv(
+            cfgInjection,
+            devAcc,
+            m_patchInjectionKernel,
+            alpaka::experimental::getMdSpan(fineBuf),
+            alpaka::experimental::getMdSpan(fineBuf),
+            m_haloSize);
+    }
+
+    StencilKernel<T_SharedMemSize1D> m_stencilKernel;
+    RefinementFlagKernel<T_BlockSize1D> m_refinementFlagKernel;
+    PatchInterpolationKernel m_patchInterpolationKernel;
+    PatchInjectionKernel m_patchInjectionKernel;
+
+    DevAcc m_devAcc;
+    alpaka::Buf<DevAcc, uint32_t, alpaka::DimInt<1u>, Idx> m_flagsAcc;
+    alpaka::Buf<alpaka::DevCpu, uint32_t, alpaka::DimInt<1u>, Idx> m_flagsHost;
+    //! patches by the 1D index of their chunk
+    std::map<Idx, Patch> m_patches;
+    Idx m_maxNumPatches = 0;
+
+    alpaka::Vec<Dim, Idx> m_numChunks;
+    alpaka::Vec<Dim, Idx> m_chunkSize;
+    alpaka::Vec<Dim, Idx> m_haloSize;
+    alpaka::Vec<Dim, Idx> m_fineExtent;
+    double m_dx;
+    double m_dy;
+    double m_dt;
+    double m_threshold;
+    WorkDiv m_workDivCore;
+    WorkDiv m_workDivFine;
+    WorkDiv m_workDivPatch;
+    WorkDiv m_workDivInjection;
+};
@@ -0,0 +1,214 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "LinearAlgebraKernels.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstdint>
+
+//! Flags the chunks of the coarse grid that need refinement
+//!
+//! The criterion is the largest magnitude of the gradient |grad u| over the core cells of a chunk, from central
+//! differences. Every block handles one chunk and reduces its maximum in shared memory.
+//!
+//! \tparam T_BlockSize1D maximum number of threads in a block (size of the shared reduction buffer)
+//!
+//! \param uBuf grid values of u on the coarse grid
+//! \param flags flag per chunk, set to one if the chunk needs refinement and to zero otherwise
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param dx step in x
+//! \param dy step in y
+//! \param threshold gradient magnitude above which a chunk is refined
+template<size_t T_BlockSize1D>
+struct RefinementFlagKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uBuf,
+        uint32_t* const flags,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const threshold) const -> void
+    {
+        auto& sdata = alpaka::declareSharedVar<double[T_BlockSize1D], __COUNTER__>(acc);
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const gridBlockExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        double threadMaxGradient = 0.0;
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                auto const globalIdx = alpaka::Vec(i, j) + haloSize + blockStartThreadIdx;
+                double const uX
+                    = (uBuf(globalIdx[0], globalIdx[1] + 1) - uBuf(globalIdx[0], globalIdx[1] - 1)) / (2.0 * dx);
+                double const uY
+                    = (uBuf(globalIdx[0] + 1, globalIdx[1]) - uBuf(globalIdx[0] - 1, globalIdx[1])) / (2.0 * dy);
+                threadMaxGradient
+                    = alpaka::math::max(acc, threadMaxGradient, alpaka::math::sqrt(acc, uX * uX + uY * uY));
+            }
+        }
+
+        double const blockMaxGradient = blockReduce(
+            acc,
+            sdata,
+            threadMaxGradient,
+            [&acc](double const a, double const b) { return alpaka::math::max(acc, a, b); });
+        if(alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u] == 0)
+        {
+            flags[alpaka::mapIdx<1>(gridBlockIdx, gridBlockExtent)[0u]] = blockMaxGradient > threshold ? 1u : 0u;
+        }
+    }
+};
+
+//! Weights of the cubic Lagrange interpolation at a position on the coarse grid in units of half a coarse cell
+//!
+//! Coarse nodes are copied, midpoints use the four closest coarse nodes, (-1, 9, 9, -1) / 16, and the one-sided
+//! weights (5, 15, -5, 1) / 16 next to the end of the coarse grid. The interpolation is fourth order, so the
+//! coarse-fine boundary does not spoil the second order accuracy of the stencil on the patch.
+//!
+//! \param half position in units of half a coarse cell
+//! \param extent number of coarse cells in this dimension including the halo
+//! \param first first of the four coarse nodes
+//! \param weights weights of the four coarse nodes
+template<typename TIdx>
+ALPAKA_FN_HOST_ACC inline auto cubicMidpointWeights(
+    TIdx const half,
+    TIdx const extent,
+    TIdx& first,
+    double (&weights)[4]) -> void
+{
+    TIdx const lower = half / 2;
+    if(half % 2 == 0)
+    {
+        first = lower;
+        weights[0] = 1.0;
+        weights[1] = weights[2] = weights[3] = 0.0;
+    }
+    else if(lower == 0)
+    {
+        first = 0;
+        weights[0] = 5.0 / 16.0;
+        weights[1] = 15.0 / 16.0;
+        weights[2] = -5.0 / 16.0;
+        weights[3] = 1.0 / 16.0;
+    }
+    else if(lower + 2 == extent)
+    {
+        first = extent - 4;
+        weights[0] = 1.0 / 16.0;
+        weights[1] = -5.0 / 16.0;
+        weights[2] = 15.0 / 16.0;
+        weights[3] = 5.0 / 16.0;
+    }
+    else
+    {
+        first = lower - 1;
+        weights[0] = weights[3] = -1.0 / 16.0;
+        weights[1] = weights[2] = 9.0 / 16.0;
+    }
+}
+
+//! Interpolates the values of a fine patch from the coarse grid
+//!
+//! The refinement ratio is two and both grids are vertex centered, the fine cell f of the patch (including its halo of
+//! one cell) lies at the coarse position coarseOrigin - 1/2 + f/2, where coarseOrigin is the first coarse core cell
+//! covered by the patch. The values are cubic in space, see cubicMidpointWeights, and linear in time between the
+//! coarse values at the beginning and the end of the coarse time step. One thread per cell of the patch.
+//!
+//! \param coarseOldBuf coarse values at the beginning of the coarse time step
+//! \param coarseNewBuf coarse values at the end of the coarse time step
+//! \param fineBuf values of the patch
+//! \param coarseOrigin first coarse core cell covered by the patch in {Y, X}, as index of the coarse buffer
+//! \param alpha position in the coarse time step, 0 at the beginning and 1 at the end
+//! \param haloOnly only fill the halo cells of the patch, as coarse-fine boundary condition
+struct PatchInterpolationKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan coarseOldBuf,
+        TMdSpan coarseNewBuf,
+        TMdSpan fineBuf,
+        alpaka::Vec<TDim, TIdx> const& coarseOrigin,
+        double const alpha,
+        bool const haloOnly) const -> void
+    {
+        auto const fineExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+        auto const fineIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        bool const isHalo = fineIdx[0] == 0 || fineIdx[0] == fineExtent[0] - 1 || fineIdx[1] == 0
+                            || fineIdx[1] == fineExtent[1] - 1;
+        if(haloOnly && !isHalo)
+            return;
+
+        TIdx firstY;
+        TIdx firstX;
+        double weightsY[4];
+        double weightsX[4];
+        cubicMidpointWeights<TIdx>(
+            2 * coarseOrigin[0] - 1 + fineIdx[0],
+            static_cast<TIdx>(coarseOldBuf.extent(0)),
+            firstY,
+            weightsY);
+        cubicMidpointWeights<TIdx>(
+            2 * coarseOrigin[1] - 1 + fineIdx[1],
+            static_cast<TIdx>(coarseOldBuf.extent(1)),
+            firstX,
+            weightsX);
+
+        double value = 0.0;
+        for(TIdx k = 0; k < 4; ++k)
+        {
+            for(TIdx l = 0; l < 4; ++l)
+            {
+                double const weight = weightsY[k] * weightsX[l];
+                if(weight != 0.0)
+                {
+                    value += weight
+                             * ((1.0 - alpha) * coarseOldBuf(firstY + k, firstX + l)
+                                + alpha * coarseNewBuf(firstY + k, firstX + l));
+                }
+            }
+        }
+        fineBuf(fineIdx[0], fineIdx[1]) = value;
+    }
+};
+
+//! Copies the values of a fine patch to the coarse cells it covers
+//!
+//! The coarse cell coarseOrigin + k coincides with the fine cell 2k + 1 of the patch. One thread per covered coarse
+//! cell.
+//!
+//! \param fineBuf values of the patch
+//! \param coarseBuf coarse grid, only the covered core cells are written
+//! \param coarseOrigin first coarse core cell covered by the patch in {Y, X}, as index of the coarse buffer
+struct PatchInjectionKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan fineBuf,
+        TMdSpan coarseBuf,
+        alpaka::Vec<TDim, TIdx> const& coarseOrigin) const -> void
+    {
+        auto const idx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        coarseBuf(coarseOrigin[0] + idx[0], coarseOrigin[1] + idx[1]) = fineBuf(2 * idx[0] + 1, 2 * idx[1] + 1);
+    }
+};
@@ -0,0 +1,176 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "AlternatingDirectionImplicitKernels.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstdint>
+
+//! Peaceman-Rachford alternating direction implicit (ADI) time stepping
+//!
+//! Every step consists of two half steps, each implicit in one dimension and explicit in the other:
+//!     (I - dt/2 Lx) u* = (I + dt/2 Ly) u(t)
+//!     (I - dt/2 Ly) u(t + dt) = (I + dt/2 Lx) u*
+//! The first half step solves one tridiagonal system per row, the second one per column. The scheme is
+//! unconditionally stable and second order in time. It is limited to the five-point stencil, which gives the
+//! tridiagonal systems.
+//!
+//! \tparam TAcc accelerator type
+template<typename TAcc>
+class AlternatingDirectionImplicit
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using BufAcc = alpaka::Buf<DevAcc, double, Dim, Idx>;
+    using WorkDiv = alpaka::WorkDivMembers<Dim, Idx>;
+
+    //! \param devAcc device the buffers are allocated on
+    //! \param numNodes number of core cells in {Y, X}
+    //! \param haloSize size of the halo in {Y, X}
+    //! \param dx step in x
+    //! \param dy step in y
+    //! \param dt step in t
+    AlternatingDirectionImplicit(
+        DevAcc const& devAcc,
+        alpaka::Vec<Dim, Idx> const& numNodes,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt)
+        : m_uStarBuf(alpaka::allocBuf<double, Idx>(devAcc, numNodes + haloSize + haloSize))
+        , m_cPrimeX(alpaka::allocBuf<double, Idx>(devAcc, numNodes[1]))
+        , m_invDenominatorX(alpaka::allocBuf<double, Idx>(devAcc, numNodes[1]))
+        , m_cPrimeY(alpaka::allocBuf<double, Idx>(devAcc, numNodes[0]))
+        , m_invDenominatorY(alpaka::allocBuf<double, Idx>(devAcc, numNodes[0]))
+        , m_numNodes(numNodes)
+        , m_haloSize(haloSize)
+        , m_dx(dx)
+        , m_dy(dy)
+        , m_dt(dt)
+        , m_rX(0.5 * dt / (dx * dx))
+        , m_rY(0.5 * dt / (dy * dy))
+        , m_workDivRows(makeWorkDiv(devAcc, m_sweepXKernel, numNodes[0]))
+        , m_workDivColumns(makeWorkDiv(devAcc, m_sweepYKernel, numNodes[1]))
+    {
+        auto const devHost = alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0);
+        alpaka::Queue<TAcc, alpaka::Blocking> queue{devAcc};
+
+        // LU factorization of the constant tridiagonal matrix shared by all lines of one dimension
+        auto factorize = [&](Idx const numCells, double const r, auto& cPrimeAcc, auto& invDenominatorAcc)
+        {
+            auto cPrimeHost = alpaka::allocBuf<double, Idx>(devHost, numCells);
+            auto invDenominatorHost = alpaka::allocBuf<double, Idx>(devHost, numCells);
+            double* const cPrime = alpaka::getPtrNative(cPrimeHost);
+            double* const invDenominator = alpaka::getPtrNative(invDenominatorHost);
+            for(Idx i = 0; i < numCells; ++i)
+            {
+                double const cPrev = i == 0 ? 0.0 : cPrime[i - 1];
+                invDenominator[i] = 1.0 / (1.0 + 2.0 * r + r * cPrev);
+                cPrime[i] = -r * invDenominator[i];
+            }
+            alpaka::memcpy(queue, cPrimeAcc, cPrimeHost);
+            alpaka::memcpy(queue, invDenominatorAcc, invDenominatorHost);
+        };
+        factorize(numNodes[1], m_rX, m_cPrimeX, m_invDenominatorX);
+        factorize(numNodes[0], m_rY, m_cPrimeY, m_invDenominatorY);
+    }
+
+    //! Advance uCurr by one time step into uNext
+    //!
+    //! \param workDivExtent work division covering the whole grid including the halo, as used by the boundary
+    //! \param boundary provider of the boundary values, see BoundaryConditions.hpp
+    //! \param step simulation timestep at the end of the step
+    template<typename TQueue, typename TBoundary>
+    auto step(
+        TQueue& queue,
+        WorkDiv const& workDivExtent,
+        TBoundary& boundary,
+        BufAcc& uCurrBuf,
+        BufAcc& uNextBuf,
+        uint32_t const step) -> void
+    {
+        // first half step, one system per row
+        alpaka::exec<TAcc>(
+            queue,
+            workDivExtent,
+            m_intermediateBoundaryKernel,
+            alpaka::experimental::getMdSpan(m_uStarBuf),
+            step,
+            m_dx,
+            m_dy,
+            m_dt);
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivRows,
+            m_sweepXKernel,
+            alpaka::experimental::getMdSpan(uCurrBuf),
+            alpaka::experimental::getMdSpan(m_uStarBuf),
+            alpaka::getPtrNative(m_cPrimeX),
+            alpaka::getPtrNative(m_invDenominatorX),
+            m_numNodes,
+            m_haloSize,
+            m_rX,
+            m_rY);
+
+        // second half step, one system per column
+        boundary.apply(queue, workDivExtent, alpaka::experimental::getMdSpan(uNextBuf), m_haloSize, step * m_dt);
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivColumns,
+            m_sweepYKernel,
+            alpaka::experimental::getMdSpan(m_uStarBuf),
+            alpaka::experimental::getMdSpan(uNextBuf),
+            alpaka::getPtrNative(m_cPrimeY),
+            alpaka::getPtrNative(m_invDenominatorY),
+            m_numNodes,
+            m_haloSize,
+            m_rY,
+            m_rX);
+    }
+
+private:
+    //! One thread per line, the lines are mapped to the x dimension of the grid
+    template<typename TKernel>
+    auto makeWorkDiv(DevAcc const& devAcc, TKernel const& kernel, Idx const numLines) -> WorkDiv
+    {
+        alpaka::KernelCfg<TAcc> const cfgLines = {alpaka::Vec<Dim, Idx>{1, numLines}, alpaka::Vec<Dim, Idx>{1, 1}};
+        return alpaka::getValidWorkDiv(
+            cfgLines,
+            devAcc,
+            kernel,
+            alpaka::experimental::getMdSpan(m_uStarBuf),
+            alpaka::experimental::getMdSpan(m_uStarBuf),
+            alpaka::getPtrNative(m_cPrimeX),
+            alpaka::getPtrNative(m_invDenominatorX),
+            m_numNodes,
+            m_haloSize,
+            m_rX,
+            m_rY);
+    }
+
+    TridiagonalSweepKernel<1u> m_sweepXKernel;
+    TridiagonalSweepKernel<0u> m_sweepYKernel;
+    AdiIntermediateBoundaryKernel m_intermediateBoundaryKernel;
+
+    BufAcc m_uStarBuf;
+    alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx> m_cPrimeX;
+    alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx> m_invDenominatorX;
+    alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx> m_cPrimeY;
+    alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx> m_invDenominatorY;
+
+    alpaka::Vec<Dim, Idx> m_numNodes;
+    alpaka::Vec<Dim, Idx> m_haloSize;
+    double m_dx;
+    double m_dy;
+    double m_dt;
+    double m_rX;
+    double m_rY;
+    WorkDiv m_workDivRows;
+    WorkDiv m_workDivColumns;
+};
@@ -0,0 +1,144 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "analyticalSolution.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+//! Batched Thomas algorithm for one half step of the Peaceman-Rachford ADI scheme
+//!
+//! \tparam T_ImplicitDim dimension which is treated implicitly, 0 for y (one system per column) and 1 for x (one
+//!                       system per row)
+//!
+//! Every thread solves the tridiagonal system of one grid line
+//!     -rImplicit * u_{i-1} + (1 + 2 rImplicit) * u_i - rImplicit * u_{i+1} = d_i
+//! where d is the other dimension treated explicitly, d = (I + rExplicit * delta^2) uIn. All systems share the same
+//! matrix, so its LU factorization is precomputed once and passed in as cPrime and invDenominator.
+//!
+//! \param uInBuf values at the beginning of the half step
+//! \param uOutBuf values at the end of the half step, the halo cells have to hold the boundary values
+//! \param cPrime modified upper diagonal of the factorization, one value per core cell of a line
+//! \param invDenominator inverse pivots of the factorization, one value per core cell of a line
+//! \param numNodes number of core cells in {Y, X}
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param rImplicit dt / 2 / h^2 of the implicit dimension
+//! \param rExplicit dt / 2 / h^2 of the explicit dimension
+template<size_t T_ImplicitDim>
+struct TridiagonalSweepKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uInBuf,
+        TMdSpan uOutBuf,
+        double const* const cPrime,
+        double const* const invDenominator,
+        alpaka::Vec<TDim, TIdx> const& numNodes,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const rImplicit,
+        double const rExplicit) const -> void
+    {
+        constexpr size_t explicitDim = 1u - T_ImplicitDim;
+
+        // one thread per grid line
+        auto const line = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc)[1];
+        if(line >= numNodes[explicitDim])
+            return;
+
+        // global index of core cell i of the line, shifted by offset in the explicit dimension
+        auto globalIdx = [&](TIdx const i, int const offset = 0)
+        {
+            alpaka::Vec<TDim, TIdx> idx = haloSize;
+            idx[T_ImplicitDim] += i;
+            idx[explicitDim] = static_cast<TIdx>(static_cast<int>(idx[explicitDim] + line) + offset);
+            return idx;
+        };
+        auto const numCells = numNodes[T_ImplicitDim];
+
+        // forward elimination, the intermediate results are kept in the output buffer
+        double dPrev = 0.0;
+        for(TIdx i = 0; i < numCells; ++i)
+        {
+            auto const idx = globalIdx(i);
+            auto const idxMinus = globalIdx(i, -1);
+            auto const idxPlus = globalIdx(i, 1);
+            double d = uInBuf(idx[0], idx[1])
+                       + rExplicit
+                             * (uInBuf(idxMinus[0], idxMinus[1]) - 2.0 * uInBuf(idx[0], idx[1])
+                                + uInBuf(idxPlus[0], idxPlus[1]));
+
+            // the Dirichlet values next to the first and last cell move to the right hand side
+            if(i == 0 || i == numCells - 1)
+            {
+                auto boundaryIdx = idx;
+                boundaryIdx[T_ImplicitDim]
+                    = i == 0 ? haloSize[T_ImplicitDim] - 1 : numCells + haloSize[T_ImplicitDim];
+                d += rImplicit * uOutBuf(boundaryIdx[0], boundaryIdx[1]);
+            }
+
+            dPrev = (d + rImplicit * dPrev) * invDenominator[i];
+            uOutBuf(idx[0], idx[1]) = dPrev;
+        }
+
+        // back substitution
+        for(TIdx i = numCells - 1; i > 0; --i)
+        {
+            auto const idx = globalIdx(i - 1);
+            auto const idxNext = globalIdx(i);
+            uOutBuf(idx[0], idx[1]) -= cPrime[i - 1] * uOutBuf(idxNext[0], idxNext[1]);
+        }
+    }
+};
+
+//! Sets the boundary values of the intermediate ADI solution u* at x = 0 and x = 1
+//!
+//! Adding both Peaceman-Rachford half steps gives u* = 1/2 ((I + a Ly) u(t) + (I - a Ly) u(t + dt)) with a = dt / 2,
+//! which is evaluated along the boundary columns from the analytical solution. Using u(t + dt / 2) instead would
+//! reduce the scheme to first order near the boundary.
+//!
+//! \param uStarBuf intermediate solution, only the core rows of the first and last column are written
+//! \param step simulation timestep of the end of the ADI step
+//! \param dx step in x
+//! \param dy step in y
+//! \param dt step in t
+struct AdiIntermediateBoundaryKernel
+{
+    template<typename TAcc, typename TMdSpan>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uStarBuf,
+        uint32_t step,
+        double const dx,
+        double const dy,
+        double const dt) const -> void
+    {
+        // Get extents(dimensions)
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+
+        // Get indexes
+        auto const globalIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        if((globalIdx[1] == 0 || globalIdx[1] == gridThreadExtent[1] - 1) && globalIdx[0] > 0
+           && globalIdx[0] < gridThreadExtent[0] - 1)
+        {
+            double const x = globalIdx[1] * dx;
+            double const y = globalIdx[0] * dy;
+            double const a = 0.5 * dt / (dy * dy);
+
+            // (I + sign * a Ly) applied to the boundary values at time t
+            auto boundaryOperator = [&](double const t, double const sign) -> double
+            {
+                double const u = analyticalSolution(acc, x, y, t);
+                double const uMinus = analyticalSolution(acc, x, y - dy, t);
+                double const uPlus = analyticalSolution(acc, x, y + dy, t);
+                return u + sign * a * (uMinus - 2.0 * u + uPlus);
+            };
+
+            uStarBuf(globalIdx[0], globalIdx[1])
+                = 0.5 * (boundaryOperator((step - 1) * dt, 1.0) + boundaryOperator(step * dt, -1.0));
+        }
+    }
+};
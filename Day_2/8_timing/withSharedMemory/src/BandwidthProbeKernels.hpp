@@ -0,0 +1,75 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+//! Kernels of the STREAM benchmark, every thread handles the elements i, i + numThreads, ... of the arrays, so any
+//! work division covers them.
+//!
+//! \param a resulting array of n elements
+//! \param b first input array of n elements
+//! \param c second input array of n elements, triad only
+//! \param scalar factor of the input, scale and triad only
+//! \param n number of elements
+
+//! a = b
+struct CopyKernel
+{
+    template<typename TAcc, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(TAcc const& acc, double* const a, double const* const b, TIdx const n) const -> void
+    {
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+        auto const numThreads = static_cast<TIdx>(gridThreadExtent.prod());
+        auto const gridThreadIdx1D = static_cast<TIdx>(
+            alpaka::mapIdx<1>(alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc), gridThreadExtent)[0u]);
+
+        for(TIdx i = gridThreadIdx1D; i < n; i += numThreads)
+            a[i] = b[i];
+    }
+};
+
+//! a = scalar * b
+struct ScaleKernel
+{
+    template<typename TAcc, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        double* const a,
+        double const* const b,
+        double const scalar,
+        TIdx const n) const -> void
+    {
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+        auto const numThreads = static_cast<TIdx>(gridThreadExtent.prod());
+        auto const gridThreadIdx1D = static_cast<TIdx>(
+            alpaka::mapIdx<1>(alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc), gridThreadExtent)[0u]);
+
+        for(TIdx i = gridThreadIdx1D; i < n; i += numThreads)
+            a[i] = scalar * b[i];
+    }
+};
+
+//! a = b + scalar * c
+struct TriadKernel
+{
+    template<typename TAcc, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        double* const a,
+        double const* const b,
+        double const* const c,
+        double const scalar,
+        TIdx const n) const -> void
+    {
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+        auto const numThreads = static_cast<TIdx>(gridThreadExtent.prod());
+        auto const gridThreadIdx1D = static_cast<TIdx>(
+            alpaka::mapIdx<1>(alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc), gridThreadExtent)[0u]);
+
+        for(TIdx i = gridThreadIdx1D; i < n; i += numThreads)
+            a[i] = b[i] + scalar * c[i];
+    }
+};
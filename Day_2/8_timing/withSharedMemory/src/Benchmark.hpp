@@ -0,0 +1,235 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+//! Performance regression test of the benchmark build
+//!
+//! With ENABLE_BENCHMARK the measured metrics of an accelerator are compared to its baseline in the JSON file in
+//! HEAT_EQUATION_BASELINE or baseline.json:
+//!     {
+//!       "tolerance": 0.25,
+//!       "accelerators": {
+//!         "TagCpuOmp2Blocks": {"MLUP/s": 812.5, "StencilKernel [us]": 21.3}
+//!       }
+//!     }
+//! A metric regresses if it is worse than its baseline by more than the relative tolerance. The baselines only hold
+//! for the machine they were recorded on, HEAT_EQUATION_UPDATE_BASELINE=1 stores the measured metrics of the
+//! accelerator as its new baseline instead of comparing them.
+#ifdef ENABLE_BENCHMARK
+constexpr bool benchmark = true;
+#else
+constexpr bool benchmark = false;
+#endif
+
+//! Exit code of a benchmark without a baseline, CTest reports the test as skipped with SKIP_RETURN_CODE
+constexpr int benchmarkSkipped = 77;
+
+//! Measured value of the benchmark
+struct BenchmarkMetric
+{
+    std::string name;
+    double value;
+    //! whether larger values are better, e.g. for a rate, otherwise smaller ones are, e.g. for a time
+    bool higherIsBetter;
+};
+
+//! Contents of the baseline file
+struct BenchmarkBaselines
+{
+    double tolerance = 0.25;
+    //! metric name and value per accelerator
+    std::map<std::string, std::map<std::string, double>> accelerators;
+
+    //! Reads the baselines, a missing file has none
+    static auto read(std::string const& path) -> BenchmarkBaselines
+    {
+        BenchmarkBaselines baselines;
+        std::ifstream file{path};
+        if(!file)
+            return baselines;
+        std::stringstream content;
+        content << file.rdbuf();
+        JsonReader reader{content.str()};
+
+        reader.expect('{');
+        while(!reader.consume('}'))
+        {
+            auto const key = reader.string();
+            reader.expect(':');
+            if(key == "tolerance")
+                baselines.tolerance = reader.number();
+            else if(key == "accelerators")
+            {
+                reader.expect('{');
+                while(!reader.consume('}'))
+                {
+                    auto& metrics = baselines.accelerators[reader.string()];
+                    reader.expect(':');
+                    reader.expect('{');
+                    while(!reader.consume('}'))
+                    {
+                        auto const name = reader.string();
+                        reader.expect(':');
+                        metrics[name] = reader.number();
+                        reader.consume(',');
+                    }
+                    reader.consume(',');
+                }
+            }
+            else
+                throw std::runtime_error{"Unknown key " + key + " in the baseline file " + path};
+            reader.consume(',');
+        }
+        return baselines;
+    }
+
+    auto write(std::string const& path) const -> void
+    {
+        std::ofstream file{path};
+        file << std::setprecision(6) << "{\n  \"tolerance\": " << tolerance << ",\n  \"accelerators\": {";
+        for(auto accelerator = accelerators.begin(); accelerator != accelerators.end(); ++accelerator)
+        {
+            file << (accelerator == accelerators.begin() ? "\n" : ",\n") << "    \"" << accelerator->first << "\": {";
+            for(auto metric = accelerator->second.begin(); metric != accelerator->second.end(); ++metric)
+            {
+                file << (metric == accelerator->second.begin() ? "\n" : ",\n") << "      \"" << metric->first
+                     << "\": " << metric->second;
+            }
+            file << "\n    }";
+        }
+        file << "\n  }\n}\n";
+    }
+
+private:
+    //! Reader of the subset of JSON the baseline file uses, objects of strings and numbers
+    class JsonReader
+    {
+    public:
+        explicit JsonReader(std::string text) : m_text{std::move(text)}
+        {
+        }
+
+        //! Skips the character c if it is next, returns whether it was
+        auto consume(char const c) -> bool
+        {
+            skipWhitespace();
+            if(m_pos < m_text.size() && m_text[m_pos] == c)
+            {
+                ++m_pos;
+                return true;
+            }
+            return false;
+        }
+
+        auto expect(char const c) -> void
+        {
+            if(!consume(c))
+                throw std::runtime_error{std::string{"Expected '"} + c + "' in the baseline file"};
+        }
+
+        auto string() -> std::string
+        {
+            expect('"');
+            auto const end = m_text.find('"', m_pos);
+            if(end == std::string::npos)
+                throw std::runtime_error{"Unterminated string in the baseline file"};
+            auto value = m_text.substr(m_pos, end - m_pos);
+            m_pos = end + 1;
+            return value;
+        }
+
+        auto number() -> double
+        {
+            skipWhitespace();
+            std::size_t length = 0;
+            double const value = std::stod(m_text.substr(m_pos), &length);
+            m_pos += length;
+            return value;
+        }
+
+    private:
+        auto skipWhitespace() -> void
+        {
+            while(m_pos < m_text.size() && std::isspace(static_cast<unsigned char>(m_text[m_pos])))
+                ++m_pos;
+        }
+
+        std::string m_text;
+        std::size_t m_pos = 0;
+    };
+};
+
+//! Compares the metrics of the accelerator to its baseline, or records them as the baseline
+//!
+//! \param accelerator name of the accelerator tag, the key of the baseline
+//! \param metrics measured values
+//! \return EXIT_SUCCESS, EXIT_FAILURE if a metric regressed or benchmarkSkipped without a baseline
+auto compareToBaseline(std::string const& accelerator, std::vector<BenchmarkMetric> const& metrics) -> int
+{
+    char const* const pathVariable = std::getenv("HEAT_EQUATION_BASELINE");
+    std::string const path = pathVariable != nullptr ? pathVariable : "baseline.json";
+    auto baselines = BenchmarkBaselines::read(path);
+
+    char const* const update = std::getenv("HEAT_EQUATION_UPDATE_BASELINE");
+    if(update != nullptr && std::string{update} == "1")
+    {
+        auto& recorded = baselines.accelerators[accelerator];
+        for(auto const& metric : metrics)
+            recorded[metric.name] = metric.value;
+        baselines.write(path);
+        std::cout << "Baseline of " << accelerator << " written to " << path << std::endl;
+        return EXIT_SUCCESS;
+    }
+
+    auto const baseline = baselines.accelerators.find(accelerator);
+    if(baseline == baselines.accelerators.end())
+    {
+        std::cout << "No baseline of " << accelerator << " in " << path
+                  << ", record one with HEAT_EQUATION_UPDATE_BASELINE=1." << std::endl;
+        return benchmarkSkipped;
+    }
+
+    auto const precision = std::cout.precision(4);
+    std::cout << "Benchmark of " << accelerator << " compared to " << path << " with a tolerance of "
+              << baselines.tolerance * 100.0 << " %:" << std::endl;
+    int result = EXIT_SUCCESS;
+    for(auto const& metric : metrics)
+    {
+        auto const recorded = baseline->second.find(metric.name);
+        std::cout << "  " << metric.name << ": " << metric.value;
+        if(recorded == baseline->second.end())
+        {
+            std::cout << ", no baseline" << std::endl;
+            continue;
+        }
+        // positive if the metric got worse
+        double const difference
+            = metric.higherIsBetter ? recorded->second - metric.value : metric.value - recorded->second;
+        double const change = difference / recorded->second;
+        std::cout << " (baseline " << recorded->second << ", " << (change > 0.0 ? "worse" : "better") << " by "
+                  << std::abs(change) * 100.0 << " %)";
+        if(change > baselines.tolerance)
+        {
+            std::cout << " REGRESSION";
+            result = EXIT_FAILURE;
+        }
+        std::cout << std::endl;
+    }
+    std::cout.precision(precision);
+    return result;
+}
@@ -0,0 +1,132 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "BoundaryKernel.hpp"
+#include "analyticalSolution.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstdint>
+
+//! Providers of the boundary values of the 2D simulation
+//!
+//! A provider sets all halo cells of a buffer to the boundary values at a given time with
+//!     apply(queue, workDivExtent, uBuf, haloSize, time)
+//! where workDivExtent covers the whole grid including the halo and uBuf is an mdspan of the buffer. Kernel is the
+//! type of the kernel apply launches, it declares the cost of a boundary cell for the roofline.
+
+//! Evaluates the analytical solution directly in every boundary cell
+//!
+//! Works for any boundary condition, use it for boundary values that cannot be separated in space and time.
+//!
+//! \tparam TAcc accelerator type
+template<typename TAcc>
+class AnalyticalBoundary
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using Kernel = BoundaryKernel;
+
+    //! \param devAcc device the boundaries are applied on, unused
+    //! \param extent extent of the grid including the halo in {Y, X}, unused
+    //! \param dx step in x
+    //! \param dy step in y
+    AnalyticalBoundary(DevAcc const&, alpaka::Vec<Dim, Idx> const&, double const dx, double const dy)
+        : m_dx(dx)
+        , m_dy(dy)
+    {
+    }
+
+    template<typename TQueue, typename TWorkDiv, typename TMdSpan>
+    auto apply(
+        TQueue& queue,
+        TWorkDiv const& workDivExtent,
+        TMdSpan uBuf,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const time) const -> void
+    {
+        alpaka::exec<TAcc>(queue, workDivExtent, m_boundaryKernel, uBuf, haloSize, time, m_dx, m_dy);
+    }
+
+private:
+    BoundaryKernel m_boundaryKernel;
+
+    double m_dx;
+    double m_dy;
+};
+
+//! Boundary values of the form u(x, y, t) = timeFactor(t) * (profileX(x) + profileY(y))
+//!
+//! The spatial profiles of the test problem are computed once into device memory. Every application only evaluates
+//! the time factor on the host, applying the boundaries becomes a scaled copy of the profiles.
+//!
+//! \tparam TAcc accelerator type
+template<typename TAcc>
+class SeparableBoundary
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using ProfileBuf = alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx>;
+    using Kernel = SeparableBoundaryKernel;
+
+    //! \param devAcc device the profiles are allocated on
+    //! \param extent extent of the grid including the halo in {Y, X}
+    //! \param dx step in x
+    //! \param dy step in y
+    //! \param offset index of the first cell of the grid in {Y, X} if it is a part of a larger domain
+    SeparableBoundary(
+        DevAcc const& devAcc,
+        alpaka::Vec<Dim, Idx> const& extent,
+        double const dx,
+        double const dy,
+        alpaka::Vec<Dim, Idx> const& offset = alpaka::Vec<Dim, Idx>::zeros())
+        : m_profileX(alpaka::allocBuf<double, Idx>(devAcc, extent[1]))
+        , m_profileY(alpaka::allocBuf<double, Idx>(devAcc, extent[0]))
+    {
+        auto const devHost = alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0);
+        alpaka::Queue<TAcc, alpaka::Blocking> queue{devAcc};
+
+        auto fillProfile = [&](Idx const numCells, Idx const first, double const h, ProfileBuf& profileAcc)
+        {
+            auto profileHost = alpaka::allocBuf<double, Idx>(devHost, numCells);
+            double* const profile = alpaka::getPtrNative(profileHost);
+            for(Idx i = 0; i < numCells; ++i)
+                profile[i] = analyticalProfile((first + i) * h);
+            alpaka::memcpy(queue, profileAcc, profileHost);
+        };
+        fillProfile(extent[1], offset[1], dx, m_profileX);
+        fillProfile(extent[0], offset[0], dy, m_profileY);
+    }
+
+    template<typename TQueue, typename TWorkDiv, typename TMdSpan>
+    auto apply(
+        TQueue& queue,
+        TWorkDiv const& workDivExtent,
+        TMdSpan uBuf,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const time) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            workDivExtent,
+            m_separableBoundaryKernel,
+            uBuf,
+            alpaka::getPtrNative(m_profileX),
+            alpaka::getPtrNative(m_profileY),
+            haloSize,
+            analyticalTimeFactor(time));
+    }
+
+private:
+    SeparableBoundaryKernel m_separableBoundaryKernel;
+
+    ProfileBuf m_profileX;
+    ProfileBuf m_profileY;
+};
@@ -15,16 +15,31 @@
 //!
 //! \param uBuf grid values of u for each x, y and the current value of t:
 //!                 u(x, y, t)  | t = t_current
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left), all halo cells are set
 //! \param step simulation timestep
 //! \param dx step in x
 //! \param dy step in y
+//! \param dz step in z, only for 3D buffers
 //! \param dt step in t
+//!
+//! The 2D overload that takes the time directly sets the boundary values at that time instead of step * dt:
+//! \param time simulation time of the boundary values
+//!
+//! The ensemble overload takes a buffer of {E, Y, X} cells holding E independent simulations, member m follows the
+//! analytical solution with the diffusivity diffusivity[m]:
+//! \param diffusivity diffusivity of each member of the ensemble
+//! \param haloSize {0, Y, X}, the batch dimension has no halo
 struct BoundaryKernel
 {
-    template<typename TAcc, typename TMdSpan>
+    //! cost per boundary cell for the roofline, the value is only written, see analyticalSolutionFlops
+    static constexpr double bytesPerCell = sizeof(double);
+    static constexpr double flopsPerCell = analyticalSolutionFlops + 3.0;
+
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
     ALPAKA_FN_ACC auto operator()(
         TAcc const& acc,
         TMdSpan uBuf,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
         uint32_t step,
         double const dx,
         double const dy,
@@ -36,13 +51,133 @@ struct BoundaryKernel
         // Get indexes
         auto const globalIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
 
-        if(globalIdx[0] == 0 || globalIdx[0] == gridThreadExtent[0] - 1 || globalIdx[1] == 0
-           || globalIdx[1] == gridThreadExtent[1] - 1)
+        if(globalIdx[0] < haloSize[0] || globalIdx[0] >= gridThreadExtent[0] - haloSize[0]
+           || globalIdx[1] < haloSize[1] || globalIdx[1] >= gridThreadExtent[1] - haloSize[1])
         {
             uBuf(globalIdx[0], globalIdx[1])
                 = analyticalSolution(acc, globalIdx[1] * dx, globalIdx[0] * dy, step * dt);
         }
     }
+
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uBuf,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const time,
+        double const dx,
+        double const dy) const -> void
+    {
+        // Get extents(dimensions)
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+
+        // Get indexes
+        auto const globalIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        if(globalIdx[0] < haloSize[0] || globalIdx[0] >= gridThreadExtent[0] - haloSize[0]
+           || globalIdx[1] < haloSize[1] || globalIdx[1] >= gridThreadExtent[1] - haloSize[1])
+        {
+            uBuf(globalIdx[0], globalIdx[1]) = analyticalSolution(acc, globalIdx[1] * dx, globalIdx[0] * dy, time);
+        }
+    }
+
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uBuf,
+        double const* const diffusivity,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        uint32_t step,
+        double const dx,
+        double const dy,
+        double const dt) const -> void
+    {
+        // Get extents(dimensions)
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+
+        // Get indexes, the first dimension is the member of the ensemble
+        auto const globalIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        if(globalIdx[1] < haloSize[1] || globalIdx[1] >= gridThreadExtent[1] - haloSize[1]
+           || globalIdx[2] < haloSize[2] || globalIdx[2] >= gridThreadExtent[2] - haloSize[2])
+        {
+            // the solution with diffusivity a at time t is the one with unit diffusivity at time a * t
+            uBuf(globalIdx[0], globalIdx[1], globalIdx[2]) = analyticalSolution(
+                acc,
+                globalIdx[2] * dx,
+                globalIdx[1] * dy,
+                diffusivity[globalIdx[0]] * step * dt);
+        }
+    }
+
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uBuf,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        uint32_t step,
+        double const dx,
+        double const dy,
+        double const dz,
+        double const dt) const -> void
+    {
+        // Get extents(dimensions)
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+
+        // Get indexes
+        auto const globalIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        if(globalIdx[0] < haloSize[0] || globalIdx[0] >= gridThreadExtent[0] - haloSize[0]
+           || globalIdx[1] < haloSize[1] || globalIdx[1] >= gridThreadExtent[1] - haloSize[1]
+           || globalIdx[2] < haloSize[2] || globalIdx[2] >= gridThreadExtent[2] - haloSize[2])
+        {
+            uBuf(globalIdx[0], globalIdx[1], globalIdx[2]) = analyticalSolution(
+                acc,
+                globalIdx[2] * dx,
+                globalIdx[1] * dy,
+                globalIdx[0] * dz,
+                step * dt);
+        }
+    }
+};
+
+//! Applies boundary conditions of the form u(x, y, t) = timeFactor(t) * (profileX(x) + profileY(y))
+//!
+//! The spatial profiles are evaluated once and kept in device memory, so a boundary cell costs two loads and a
+//! multiplication instead of the transcendental functions of the analytical solution, see SeparableBoundary.
+//!
+//! \param uBuf grid values of u for each x, y and the current value of t
+//! \param profileX spatial profile along x for every column of the grid including the halo
+//! \param profileY spatial profile along y for every row of the grid including the halo
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left), all halo cells are set
+//! \param timeFactor time dependent factor of the boundary values at the current value of t
+struct SeparableBoundaryKernel
+{
+    //! cost per boundary cell for the roofline, the value is written and the two profiles are read
+    static constexpr double bytesPerCell = 3.0 * sizeof(double);
+    static constexpr double flopsPerCell = 2.0;
+
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uBuf,
+        double const* const profileX,
+        double const* const profileY,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const timeFactor) const -> void
+    {
+        // Get extents(dimensions)
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+
+        // Get indexes
+        auto const globalIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        if(globalIdx[0] < haloSize[0] || globalIdx[0] >= gridThreadExtent[0] - haloSize[0]
+           || globalIdx[1] < haloSize[1] || globalIdx[1] >= gridThreadExtent[1] - haloSize[1])
+        {
+            uBuf(globalIdx[0], globalIdx[1]) = timeFactor * (profileX[globalIdx[1]] + profileY[globalIdx[0]]);
+        }
+    }
 };
 
 template<typename TAcc, typename TWorkDiv, typename TQueue, typename... TArgs>
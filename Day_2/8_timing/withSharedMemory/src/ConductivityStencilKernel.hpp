@@ -0,0 +1,103 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+//! alpaka version of explicit finite-difference 2D heat equation solver with a spatially varying conductivity
+//!
+//! \tparam T_SharedMemSize1D size of the shared memory box, one box is used for u and one for k
+//!
+//! Solving equation u_t = (k u_x)_x + (k u_y)_y in flux form with forward difference in t and second-order central
+//! differences in x and y. The conductivity of a face between two cells is the harmonic mean of the conductivities of
+//! the cells, which keeps the flux continuous across jumps of k.
+//!
+//! The conductivity is tiled in shared memory alongside u, so every value of k is read from global memory once per
+//! tile instead of once per neighbour.
+//!
+//! \param uCurrBuf Current buffer with grid values of u for each x, y pair and the current value of t:
+//!                 u(x, y, t) | t = t_current
+//! \param uNextBuf resulting grid values of u for each x, y pair and the next value of t:
+//!              u(x, y, t) | t = t_current + dt
+//! \param kBuf grid values of the conductivity k for each x, y pair, including the halo
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left), has to be one
+//! \param dx step in x
+//! \param dy step in y
+//! \param dt step in t
+template<size_t T_SharedMemSize1D>
+struct ConductivityStencilKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uCurrBuf,
+        TMdSpan uNextBuf,
+        TMdSpan kBuf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt) const -> void
+    {
+        auto& sdata = alpaka::declareSharedVar<double[T_SharedMemSize1D], __COUNTER__>(acc);
+        auto& kdata = alpaka::declareSharedVar<double[T_SharedMemSize1D], __COUNTER__>(acc);
+        auto smemSize2D = chunkSize + haloSize + haloSize;
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        double const rX = dt / (dx * dx);
+        double const rY = dt / (dy * dy);
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // fill shared memory
+        for(auto i = blockThreadIdx[0]; i < smemSize2D[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < smemSize2D[1]; j += blockThreadExtent[1])
+            {
+                auto localIdx2D = alpaka::Vec(i, j);
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto globalIdx = localIdx2D + blockStartThreadIdx;
+                sdata[localIdx1D] = uCurrBuf(globalIdx[0], globalIdx[1]);
+                kdata[localIdx1D] = kBuf(globalIdx[0], globalIdx[1]);
+            }
+        }
+
+        alpaka::syncBlockThreads(acc);
+
+        // harmonic mean of the conductivities of two neighbouring cells
+        auto faceConductivity = [](double const k0, double const k1) { return 2.0 * k0 * k1 / (k0 + k1); };
+
+        // go over only core cells and update nextBuf
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                // offset for halo, as we only want to go over core cells
+                auto localIdx2D = alpaka::Vec(i, j) + haloSize;
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto const globalIdx = localIdx2D + blockStartThreadIdx;
+
+                auto const rowPitch = smemSize2D[1];
+                double const u = sdata[localIdx1D];
+                double const k = kdata[localIdx1D];
+                double const kLeft = faceConductivity(k, kdata[localIdx1D - 1]);
+                double const kRight = faceConductivity(k, kdata[localIdx1D + 1]);
+                double const kUp = faceConductivity(k, kdata[localIdx1D - rowPitch]);
+                double const kDown = faceConductivity(k, kdata[localIdx1D + rowPitch]);
+
+                uNextBuf(globalIdx[0], globalIdx[1])
+                    = u
+                      + rX * (kRight * (sdata[localIdx1D + 1] - u) - kLeft * (u - sdata[localIdx1D - 1]))
+                      + rY * (kDown * (sdata[localIdx1D + rowPitch] - u) - kUp * (u - sdata[localIdx1D - rowPitch]));
+            }
+        }
+    }
+};
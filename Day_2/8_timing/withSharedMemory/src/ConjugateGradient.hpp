@@ -0,0 +1,188 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "LinearAlgebraKernels.hpp"
+#include "StencilKernel.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+//! Placeholder for the ConjugateGradient without preconditioning
+struct NoPreconditioner
+{
+};
+
+//! Matrix-free conjugate gradient solver for the implicit heat equation step
+//!
+//! Solves (I - theta * dt * L) x = b on the core cells, where L is the Laplacian of the stencil. The operator is
+//! applied with the explicit StencilKernel using the time step -theta * dt, so it shares its tiling and halo handling.
+//! The halo cells of x hold the Dirichlet boundary values and are kept fixed, the search directions have zero halos.
+//!
+//! A symmetric positive definite preconditioner M can be passed to solve. It has to provide apply(queue, r, z), which
+//! computes z = M^-1 r on the core cells, e.g. a multigrid V-cycle.
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_SharedMemSize1D size of the shared memory box of the StencilKernel
+//! \tparam T_BlockSize1D maximum number of threads in a block, used for the block reduction
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+template<typename TAcc, size_t T_SharedMemSize1D, size_t T_BlockSize1D, typename T_Stencil = FivePointStencil>
+class ConjugateGradient
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using BufAcc = alpaka::Buf<DevAcc, double, Dim, Idx>;
+    using WorkDiv = alpaka::WorkDivMembers<Dim, Idx>;
+
+    //! \param devAcc device the solver buffers are allocated on
+    //! \param extent extent of the grid including the halo
+    //! \param workDivCore work division with one block per chunk
+    //! \param chunkSize size of the chunk handled by one block
+    //! \param haloSize size of the halo in {Y, X}
+    //! \param dx step in x
+    //! \param dy step in y
+    //! \param thetaDt implicit part of the time step, theta * dt
+    //! \param tolerance relative residual norm at which the iteration stops
+    //! \param maxIterations upper limit of iterations per solve
+    ConjugateGradient(
+        DevAcc const& devAcc,
+        alpaka::Vec<Dim, Idx> const& extent,
+        WorkDiv const& workDivCore,
+        alpaka::Vec<Dim, Idx> const& chunkSize,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const thetaDt,
+        double const tolerance = 1e-10,
+        uint32_t const maxIterations = 1000)
+        : m_rBuf(alpaka::allocBuf<double, Idx>(devAcc, extent))
+        , m_pBuf(alpaka::allocBuf<double, Idx>(devAcc, extent))
+        , m_qBuf(alpaka::allocBuf<double, Idx>(devAcc, extent))
+        , m_zBuf(alpaka::allocBuf<double, Idx>(devAcc, extent))
+        , m_dot(devAcc)
+        , m_workDivCore(workDivCore)
+        , m_chunkSize(chunkSize)
+        , m_haloSize(haloSize)
+        , m_dx(dx)
+        , m_dy(dy)
+        , m_thetaDt(thetaDt)
+        , m_tolerance(tolerance)
+        , m_maxIterations(maxIterations)
+    {
+    }
+
+    //! Solve the system, x holds the initial guess and the boundary values on entry and the solution on exit
+    //!
+    //! \param preconditioner optional preconditioner, see the class description
+    //! \return number of iterations
+    template<typename TQueue, typename TPreconditioner = NoPreconditioner>
+    auto solve(TQueue& queue, BufAcc& xBuf, BufAcc& bBuf, TPreconditioner&& preconditioner = {}) -> uint32_t
+    {
+        constexpr bool isPreconditioned = !std::is_same_v<std::decay_t<TPreconditioner>, NoPreconditioner>;
+        // without preconditioner z = r
+        auto& zBuf = isPreconditioned ? m_zBuf : m_rBuf;
+
+        // residual and search direction only live on the core cells
+        alpaka::memset(queue, m_rBuf, 0);
+        alpaka::memset(queue, m_pBuf, 0);
+
+        double const bNorm = std::sqrt(dot(queue, bBuf, bBuf));
+
+        // r = b - A x, z = M^-1 r, p = z
+        applyOperator(queue, xBuf, m_qBuf);
+        waxpby(queue, m_rBuf, bBuf, m_qBuf, 1.0, -1.0);
+        if constexpr(isPreconditioned)
+            preconditioner.apply(queue, m_rBuf, m_zBuf);
+        waxpby(queue, m_pBuf, zBuf, zBuf, 1.0, 0.0);
+        double rr = dot(queue, m_rBuf, m_rBuf);
+        double rz = isPreconditioned ? dot(queue, m_rBuf, m_zBuf) : rr;
+
+        uint32_t iteration = 0;
+        while(iteration < m_maxIterations && std::sqrt(rr) > m_tolerance * bNorm)
+        {
+            // q = A p
+            applyOperator(queue, m_pBuf, m_qBuf);
+            double const alpha = rz / dot(queue, m_pBuf, m_qBuf);
+
+            // x = x + alpha p, r = r - alpha q
+            waxpby(queue, xBuf, xBuf, m_pBuf, 1.0, alpha);
+            waxpby(queue, m_rBuf, m_rBuf, m_qBuf, 1.0, -alpha);
+
+            rr = dot(queue, m_rBuf, m_rBuf);
+            if constexpr(isPreconditioned)
+                preconditioner.apply(queue, m_rBuf, m_zBuf);
+            double const rzNext = isPreconditioned ? dot(queue, m_rBuf, m_zBuf) : rr;
+
+            // p = z + beta p
+            waxpby(queue, m_pBuf, zBuf, m_pBuf, 1.0, rzNext / rz);
+            rz = rzNext;
+            ++iteration;
+        }
+        return iteration;
+    }
+
+private:
+    //! out = (I - theta * dt * L) in on the core cells
+    template<typename TQueue>
+    auto applyOperator(TQueue& queue, BufAcc& inBuf, BufAcc& outBuf) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            m_stencilKernel,
+            alpaka::experimental::getMdSpan(inBuf),
+            alpaka::experimental::getMdSpan(outBuf),
+            m_chunkSize,
+            m_haloSize,
+            m_dx,
+            m_dy,
+            -m_thetaDt);
+    }
+
+    template<typename TQueue>
+    auto waxpby(TQueue& queue, BufAcc& wBuf, BufAcc& xBuf, BufAcc& yBuf, double const a, double const b) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            m_waxpbyKernel,
+            alpaka::experimental::getMdSpan(wBuf),
+            alpaka::experimental::getMdSpan(xBuf),
+            alpaka::experimental::getMdSpan(yBuf),
+            m_chunkSize,
+            m_haloSize,
+            a,
+            b);
+    }
+
+    template<typename TQueue>
+    auto dot(TQueue& queue, BufAcc& xBuf, BufAcc& yBuf) -> double
+    {
+        return m_dot(queue, m_workDivCore, xBuf, yBuf, m_chunkSize, m_haloSize);
+    }
+
+    StencilKernel<T_SharedMemSize1D, T_Stencil> m_stencilKernel;
+    WaxpbyKernel m_waxpbyKernel;
+
+    BufAcc m_rBuf;
+    BufAcc m_pBuf;
+    BufAcc m_qBuf;
+    BufAcc m_zBuf;
+    DotProduct<TAcc, T_BlockSize1D> m_dot;
+
+    WorkDiv m_workDivCore;
+    alpaka::Vec<Dim, Idx> m_chunkSize;
+    alpaka::Vec<Dim, Idx> m_haloSize;
+    double m_dx;
+    double m_dy;
+    double m_thetaDt;
+    double m_tolerance;
+    uint32_t m_maxIterations;
+};
@@ -0,0 +1,250 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "BoundaryConditions.hpp"
+#include "HaloExchangeKernels.hpp"
+#include "InitializeBufferKernel.hpp"
+#include "StencilKernel.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+//! A band of rows of the 2D domain advanced with the explicit scheme on one accelerator
+//!
+//! The domain is split along y, the part holds the core rows [firstRow, firstRow + numRows) of the global grid with
+//! a halo of haloSize rows on both sides in its own buffers. Halo rows facing another part are exchanged through host
+//! memory, see packRows and unpackRows, the other halo cells get the boundary values. The parts of one domain may run
+//! on accelerators of different back-ends.
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_SharedMemSize1D size of the shared memory box of the StencilKernel
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+template<typename TAcc, size_t T_SharedMemSize1D, typename T_Stencil = FivePointStencil>
+class DomainPart
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using BufAcc = alpaka::Buf<DevAcc, double, Dim, Idx>;
+    using BufHost = alpaka::Buf<alpaka::DevCpu, double, Dim, Idx>;
+    using RowsHost = alpaka::Buf<alpaka::DevCpu, double, alpaka::DimInt<1u>, Idx>;
+    using WorkDiv = alpaka::WorkDivMembers<Dim, Idx>;
+
+    //! \param devAcc device the part is allocated on
+    //! \param firstRow first core row of the part in the global grid, without the halo
+    //! \param numRows number of core rows, a multiple of chunkSize[0]
+    //! \param numColumns number of core columns, a multiple of chunkSize[1]
+    //! \param chunkSize size of the chunk handled by one block
+    //! \param haloSize size of the halo in {Y, X}
+    //! \param dx step in x
+    //! \param dy step in y
+    //! \param dt step in t
+    DomainPart(
+        DevAcc const& devAcc,
+        Idx const firstRow,
+        Idx const numRows,
+        Idx const numColumns,
+        alpaka::Vec<Dim, Idx> const& chunkSize,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt)
+        : m_extent(alpaka::Vec<Dim, Idx>{numRows, numColumns} + haloSize + haloSize)
+        , m_uCurrBuf(alpaka::allocBuf<double, Idx>(devAcc, m_extent))
+        , m_uNextBuf(alpaka::allocBuf<double, Idx>(devAcc, m_extent))
+        , m_uBufHost(alpaka::allocBuf<double, Idx>(alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0), m_extent))
+        , m_packedAcc(alpaka::allocBuf<double, Idx>(devAcc, haloSize[0] * m_extent[1]))
+        , m_boundary(devAcc, m_extent, dx, dy, alpaka::Vec<Dim, Idx>{firstRow, 0})
+        , m_firstRow(firstRow)
+        , m_numRows(numRows)
+        , m_chunkSize(chunkSize)
+        , m_haloSize(haloSize)
+        , m_dx(dx)
+        , m_dy(dy)
+        , m_dt(dt)
+        , m_workDivExtent(makeWorkDivExtent(devAcc))
+        , m_workDivCore(makeWorkDivCore(devAcc))
+        , m_workDivRows(makeWorkDivRows(devAcc))
+    {
+    }
+
+    //! Advance the core cells by one time step and set the boundary values at time
+    template<typename TQueue>
+    auto step(TQueue& queue, double const time) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            m_stencilKernel,
+            alpaka::experimental::getMdSpan(m_uCurrBuf),
+            alpaka::experimental::getMdSpan(m_uNextBuf),
+            m_chunkSize,
+            m_haloSize,
+            m_dx,
+            m_dy,
+            m_dt);
+        m_boundary.apply(queue, m_workDivExtent, alpaka::experimental::getMdSpan(m_uNextBuf), m_haloSize, time);
+        std::swap(m_uCurrBuf, m_uNextBuf);
+    }
+
+    //! Copy haloSize[0] rows starting at the local row firstLocalRow of the current values into rowsHost
+    template<typename TQueue>
+    auto packRows(TQueue& queue, Idx const firstLocalRow, RowsHost& rowsHost) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivRows,
+            m_packRowsKernel,
+            alpaka::experimental::getMdSpan(m_uCurrBuf),
+            alpaka::getPtrNative(m_packedAcc),
+            firstLocalRow);
+        alpaka::memcpy(queue, rowsHost, m_packedAcc);
+    }
+
+    //! Overwrite haloSize[0] rows starting at the local row firstLocalRow of the current values with rowsHost
+    template<typename TQueue>
+    auto unpackRows(TQueue& queue, RowsHost const& rowsHost, Idx const firstLocalRow) -> void
+    {
+        alpaka::memcpy(queue, m_packedAcc, rowsHost);
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivRows,
+            m_unpackRowsKernel,
+            alpaka::getPtrNative(m_packedAcc),
+            alpaka::experimental::getMdSpan(m_uCurrBuf),
+            firstLocalRow);
+    }
+
+    //! Copy the rows of the part including its halo from the global grid in host memory
+    template<typename TQueue>
+    auto scatter(TQueue& queue, BufHost const& globalHost) -> void
+    {
+        auto const globalExtent = alpaka::getExtents(globalHost);
+        double const* const global = alpaka::getPtrNative(globalHost);
+        std::copy(
+            global + m_firstRow * globalExtent[1],
+            global + (m_firstRow + m_extent[0]) * globalExtent[1],
+            alpaka::getPtrNative(m_uBufHost));
+        alpaka::memcpy(queue, m_uCurrBuf, m_uBufHost);
+        alpaka::wait(queue);
+    }
+
+    //! Copy the core rows of the part and the halo rows given by [firstLocalRow, endLocalRow) to the global grid
+    template<typename TQueue>
+    auto gather(TQueue& queue, BufHost& globalHost, Idx const firstLocalRow, Idx const endLocalRow) -> void
+    {
+        alpaka::memcpy(queue, m_uBufHost, m_uCurrBuf);
+        alpaka::wait(queue);
+        auto const globalExtent = alpaka::getExtents(globalHost);
+        double const* const local = alpaka::getPtrNative(m_uBufHost);
+        std::copy(
+            local + firstLocalRow * m_extent[1],
+            local + endLocalRow * m_extent[1],
+            alpaka::getPtrNative(globalHost) + (m_firstRow + firstLocalRow) * globalExtent[1]);
+    }
+
+    auto firstRow() const -> Idx
+    {
+        return m_firstRow;
+    }
+
+    auto numRows() const -> Idx
+    {
+        return m_numRows;
+    }
+
+private:
+    //! One thread per cell of the part including the halo
+    auto makeWorkDivExtent(DevAcc const& devAcc) -> WorkDiv
+    {
+        alpaka::KernelCfg<TAcc> const cfgExtent = {m_extent, alpaka::Vec<Dim, Idx>::ones()};
+        return alpaka::getValidWorkDiv(
+            cfgExtent,
+            devAcc,
+            InitializeBufferKernel{},
+            alpaka::experimental::getMdSpan(m_uCurrBuf),
+            m_dx,
+            m_dy);
+    }
+
+    //! One block per chunk of the core cells
+    auto makeWorkDivCore(DevAcc const& devAcc) -> WorkDiv
+    {
+        auto const kernelFunctionAttributes = alpaka::getFunctionAttributes<TAcc>(
+            devAcc,
+            m_stencilKernel,
+            alpaka::experimental::getMdSpan(m_uCurrBuf),
+            alpaka::experimental::getMdSpan(m_uNextBuf),
+            m_chunkSize,
+            m_haloSize,
+            m_dx,
+            m_dy,
+            m_dt);
+        auto const maxThreadsPerBlock = kernelFunctionAttributes.maxThreadsPerBlock;
+        auto const threadsPerBlock = maxThreadsPerBlock < m_chunkSize.prod()
+                                         ? alpaka::Vec<Dim, Idx>{maxThreadsPerBlock, 1}
+                                         : m_chunkSize;
+        auto const numChunks = alpaka::Vec<Dim, Idx>{
+            m_numRows / m_chunkSize[0],
+            (m_extent[1] - 2 * m_haloSize[1]) / m_chunkSize[1]};
+        return WorkDiv{numChunks, threadsPerBlock, alpaka::Vec<Dim, Idx>::ones()};
+    }
+
+    //! One thread per value of haloSize[0] full rows
+    auto makeWorkDivRows(DevAcc const& devAcc) -> WorkDiv
+    {
+        alpaka::KernelCfg<TAcc> const cfgRows
+            = {alpaka::Vec<Dim, Idx>{m_haloSize[0], m_extent[1]}, alpaka::Vec<Dim, Idx>::ones()};
+        return alpaka::getValidWorkDiv(
+            cfgRows,
+            devAcc,
+            m_packRowsKernel,
+            alpaka::experimental::getMdSpan(m_uCurrBuf),
+            alpaka::getPtrNative(m_packedAcc),
+            Idx{0});
+    }
+
+    StencilKernel<T_SharedMemSize1D, T_Stencil> m_stencilKernel;
+    PackRowsKernel m_packRowsKernel;
+    UnpackRowsKernel m_unpackRowsKernel;
+
+    alpaka::Vec<Dim, Idx> m_extent;
+    BufAcc m_uCurrBuf;
+    BufAcc m_uNextBuf;
+    BufHost m_uBufHost;
+    alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx> m_packedAcc;
+    SeparableBoundary<TAcc> m_boundary;
+
+    Idx m_firstRow;
+    Idx m_numRows;
+    alpaka::Vec<Dim, Idx> m_chunkSize;
+    alpaka::Vec<Dim, Idx> m_haloSize;
+    double m_dx;
+    double m_dy;
+    double m_dt;
+    WorkDiv m_workDivExtent;
+    WorkDiv m_workDivCore;
+    WorkDiv m_workDivRows;
+};
+
+//! Number of chunk rows of the first part such that both parts take the same time per step
+//!
+//! \param numChunkRows number of chunk rows of the whole domain
+//! \param throughputFirst measured rows per second of the first part
+//! \param throughputSecond measured rows per second of the second part
+//! \return the share of the first part, at least one chunk row is left to every part
+template<typename TIdx>
+auto balanceChunkRows(TIdx const numChunkRows, double const throughputFirst, double const throughputSecond) -> TIdx
+{
+    double const share = throughputFirst / (throughputFirst + throughputSecond);
+    auto const chunkRows = static_cast<TIdx>(std::lround(share * numChunkRows));
+    return std::clamp(chunkRows, TIdx{1}, numChunkRows - 1);
+}
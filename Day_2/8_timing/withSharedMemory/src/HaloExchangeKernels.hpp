@@ -0,0 +1,47 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+//! Copies consecutive full rows of a grid into a contiguous buffer
+//!
+//! Rows are the unit of the halo exchange between the parts of a domain split along y. The packed buffer can be
+//! copied between devices of different back-ends with a plain memcpy. One thread per packed value, the grid of threads
+//! covers {number of rows, row length}.
+//!
+//! \param uBuf grid values of u
+//! \param packed contiguous buffer of the rows
+//! \param firstRow first row of the grid to copy
+struct PackRowsKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(TAcc const& acc, TMdSpan uBuf, double* const packed, TIdx const firstRow) const
+        -> void
+    {
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+        auto const idx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        packed[alpaka::mapIdx<1>(idx, gridThreadExtent)[0u]] = uBuf(firstRow + idx[0], idx[1]);
+    }
+};
+
+//! Copies the rows of a contiguous buffer into consecutive full rows of a grid, see PackRowsKernel
+//!
+//! \param packed contiguous buffer of the rows
+//! \param uBuf grid values of u
+//! \param firstRow first row of the grid to overwrite
+struct UnpackRowsKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(TAcc const& acc, double const* const packed, TMdSpan uBuf, TIdx const firstRow) const
+        -> void
+    {
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+        auto const idx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        uBuf(firstRow + idx[0], idx[1]) = packed[alpaka::mapIdx<1>(idx, gridThreadExtent)[0u]];
+    }
+};
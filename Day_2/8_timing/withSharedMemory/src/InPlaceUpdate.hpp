@@ -0,0 +1,101 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "InPlaceUpdateKernels.hpp"
+#include "SharedTileLayout.hpp"
+#include "Stencil.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cassert>
+
+//! Explicit time stepping on a single grid
+//!
+//! Every step the SaveEdgesKernel copies the cells of every chunk that its neighbours read as their halo into a small
+//! edge cache, then the InPlaceStencilKernel overwrites the chunks. The second grid of the ping-pong scheme is
+//! replaced by the edge caches, 2 * haloSize / chunkSize of the grid per dimension, and the results stay the same.
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_SharedMemSize1D size of the shared memory box of the InPlaceStencilKernel
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+//! \tparam T_TileLayout padding and alignment of the shared memory tile
+template<
+    typename TAcc,
+    size_t T_SharedMemSize1D,
+    typename T_Stencil = FivePointStencil,
+    typename T_TileLayout = SharedTileLayout<>>
+class InPlaceUpdate
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using WorkDiv = alpaka::WorkDivMembers<Dim, Idx>;
+
+    //! \param devAcc device the edge caches are allocated on
+    //! \param workDivCore work division with one block per chunk
+    //! \param numChunks number of chunks in {Y, X}
+    //! \param chunkSize size of the chunk handled by one block, at least twice the halo size
+    //! \param haloSize size of the halo in {Y, X}
+    //! \param dx step in x
+    //! \param dy step in y
+    //! \param dt step in t
+    InPlaceUpdate(
+        DevAcc const& devAcc,
+        WorkDiv const& workDivCore,
+        alpaka::Vec<Dim, Idx> const& numChunks,
+        alpaka::Vec<Dim, Idx> const& chunkSize,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt)
+        : m_edges(alpaka::allocBuf<double, Idx>(devAcc, numChunks.prod() * edgeCacheSize(chunkSize, haloSize)))
+        , m_chunkSize(chunkSize)
+        , m_haloSize(haloSize)
+        , m_dx(dx)
+        , m_dy(dy)
+        , m_dt(dt)
+        , m_workDivCore(workDivCore)
+    {
+        assert(
+            chunkSize[0] >= 2 * haloSize[0] && chunkSize[1] >= 2 * haloSize[1]
+            && "The edges of a chunk must not overlap");
+    }
+
+    //! Advance the core cells of uBuf by one time step
+    template<typename TQueue, typename TMdSpan>
+    auto step(TQueue& queue, TMdSpan uBuf) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            SaveEdgesKernel{},
+            uBuf,
+            alpaka::getPtrNative(m_edges),
+            m_chunkSize,
+            m_haloSize);
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            InPlaceStencilKernel<T_SharedMemSize1D, T_Stencil, T_TileLayout>{},
+            uBuf,
+            static_cast<double const*>(alpaka::getPtrNative(m_edges)),
+            m_chunkSize,
+            m_haloSize,
+            m_dx,
+            m_dy,
+            m_dt);
+    }
+
+private:
+    alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx> m_edges;
+    alpaka::Vec<Dim, Idx> m_chunkSize;
+    alpaka::Vec<Dim, Idx> m_haloSize;
+    double m_dx;
+    double m_dy;
+    double m_dt;
+    WorkDiv m_workDivCore;
+};
@@ -0,0 +1,188 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "SharedTileLayout.hpp"
+#include "Stencil.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+//! Number of cells of a chunk that the neighbouring chunks read as their halo
+//!
+//! The edge cache of a chunk holds the haloSize[0] top and bottom rows and then the haloSize[1] left and right
+//! columns of every row of the chunk, the corner cells are stored twice.
+//!
+//! \param chunkSize size of the chunk in {Y, X}, at least twice the halo size
+//! \param haloSize size of the halo in {Y, X}
+template<typename TDim, typename TIdx>
+ALPAKA_FN_HOST_ACC constexpr auto edgeCacheSize(
+    alpaka::Vec<TDim, TIdx> const& chunkSize,
+    alpaka::Vec<TDim, TIdx> const& haloSize) -> TIdx
+{
+    return 2 * haloSize[0] * chunkSize[1] + 2 * chunkSize[0] * haloSize[1];
+}
+
+//! Cell {Y, X} of the chunk that is stored at index k of its edge cache
+template<typename TDim, typename TIdx>
+ALPAKA_FN_HOST_ACC constexpr auto edgeCacheCell(
+    TIdx const k,
+    alpaka::Vec<TDim, TIdx> const& chunkSize,
+    alpaka::Vec<TDim, TIdx> const& haloSize) -> alpaka::Vec<TDim, TIdx>
+{
+    TIdx const numRowCells = 2 * haloSize[0] * chunkSize[1];
+    if(k < numRowCells)
+    {
+        TIdx const row = k / chunkSize[1];
+        return {row < haloSize[0] ? row : chunkSize[0] - 2 * haloSize[0] + row, k % chunkSize[1]};
+    }
+    TIdx const column = (k - numRowCells) % (2 * haloSize[1]);
+    return {
+        (k - numRowCells) / (2 * haloSize[1]),
+        column < haloSize[1] ? column : chunkSize[1] - 2 * haloSize[1] + column};
+}
+
+//! Index in the edge cache of the chunk of the cell {i, j} of the chunk, the cell has to be in the edge
+template<typename TDim, typename TIdx>
+ALPAKA_FN_HOST_ACC constexpr auto edgeCacheIdx(
+    TIdx const i,
+    TIdx const j,
+    alpaka::Vec<TDim, TIdx> const& chunkSize,
+    alpaka::Vec<TDim, TIdx> const& haloSize) -> TIdx
+{
+    if(i < haloSize[0] || i >= chunkSize[0] - haloSize[0])
+        return (i < haloSize[0] ? i : i - chunkSize[0] + 2 * haloSize[0]) * chunkSize[1] + j;
+    return 2 * haloSize[0] * chunkSize[1] + i * 2 * haloSize[1]
+           + (j < haloSize[1] ? j : j - chunkSize[1] + 2 * haloSize[1]);
+}
+
+//! Saves the edges of every chunk before the chunks are updated in place
+//!
+//! \param uBuf grid values of u at the current value of t
+//! \param edges edge caches of all chunks, row-major over the chunks, edgeCacheSize elements each
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+struct SaveEdgesKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uBuf,
+        double* const edges,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize) const -> void
+    {
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const gridBlockExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+        auto const chunkStart = gridBlockIdx * chunkSize + haloSize;
+
+        TIdx const cacheSize = edgeCacheSize(chunkSize, haloSize);
+        double* const cache = edges + alpaka::mapIdx<1>(gridBlockIdx, gridBlockExtent)[0u] * cacheSize;
+        for(auto k = alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u]; k < cacheSize;
+            k += blockThreadExtent.prod())
+        {
+            auto const cell = edgeCacheCell(k, chunkSize, haloSize) + chunkStart;
+            cache[k] = uBuf(cell[0], cell[1]);
+        }
+    }
+};
+
+//! Explicit stencil update that overwrites the current values
+//!
+//! \tparam T_SharedMemSize1D size of the shared memory box, at least T_TileLayout::size of the tile
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+//! \tparam T_TileLayout padding and alignment of the shared memory tile
+//!
+//! Same update as the StencilKernel with a single grid. The shared memory tile keeps the old values of the chunk while
+//! the block overwrites it. The neighbouring chunks are updated concurrently, so their cells of the halo are read
+//! from the edge caches saved by the SaveEdgesKernel. The halo at the border of the grid is only written after the
+//! step. The results are the same as with a second grid.
+//!
+//! \param uBuf grid values of u, overwritten with the values at the next value of t
+//! \param edges edge caches of all chunks with the values at the current value of t, see SaveEdgesKernel
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param dx step in x
+//! \param dy step in y
+//! \param dt step in t
+template<size_t T_SharedMemSize1D, typename T_Stencil = FivePointStencil, typename T_TileLayout = SharedTileLayout<>>
+struct InPlaceStencilKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uBuf,
+        double const* const edges,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt) const -> void
+    {
+        auto& sgroups = alpaka::declareSharedVar<
+            typename T_TileLayout::Group[T_TileLayout::numGroups(T_SharedMemSize1D)],
+            __COUNTER__>(acc);
+        double* const sdata = sgroups[0].values;
+        auto smemSize2D = chunkSize + haloSize + haloSize;
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const gridBlockExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+        auto const coreEnd = gridBlockExtent * chunkSize + haloSize;
+
+        double const rX = dt / (dx * dx);
+        double const rY = dt / (dy * dy);
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // fill shared memory, the own chunk and the border of the grid from the grid, the rest from the edge caches
+        TIdx const cacheSize = edgeCacheSize(chunkSize, haloSize);
+        auto const rowPitch = T_TileLayout::rowPitch(smemSize2D[1]);
+        double const* const tile = sdata + T_TileLayout::offset(haloSize[1]);
+        T_TileLayout::fill(
+            sgroups,
+            smemSize2D,
+            haloSize[1],
+            alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u],
+            blockThreadExtent.prod(),
+            [&](TIdx const i, TIdx const j)
+            {
+                auto const y = blockStartThreadIdx[0] + i;
+                auto const x = blockStartThreadIdx[1] + j;
+                bool const ownChunk = i >= haloSize[0] && i < haloSize[0] + chunkSize[0] && j >= haloSize[1]
+                                      && j < haloSize[1] + chunkSize[1];
+                if(ownChunk || y < haloSize[0] || y >= coreEnd[0] || x < haloSize[1] || x >= coreEnd[1])
+                    return uBuf(y, x);
+                auto const coreY = y - haloSize[0];
+                auto const coreX = x - haloSize[1];
+                auto const chunkIdx1D = coreY / chunkSize[0] * gridBlockExtent[1] + coreX / chunkSize[1];
+                return edges
+                    [chunkIdx1D * cacheSize
+                     + edgeCacheIdx(coreY % chunkSize[0], coreX % chunkSize[1], chunkSize, haloSize)];
+            });
+
+        alpaka::syncBlockThreads(acc);
+
+        // go over only core cells and overwrite them
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                // offset for halo, as we only want to go over core cells
+                auto localIdx2D = alpaka::Vec(i, j) + haloSize;
+                auto localIdx1D = localIdx2D[0] * rowPitch + localIdx2D[1];
+                auto const globalIdx = localIdx2D + blockStartThreadIdx;
+
+                uBuf(globalIdx[0], globalIdx[1])
+                    = tile[localIdx1D] + T_Stencil::laplace(tile, localIdx1D, rowPitch, rX, rY);
+            }
+        }
+    }
+};
@@ -19,15 +19,43 @@
 //!                 u(x, y, t) | t = t_current
 //! \param dx
 //! \param dy
+//! \param dz only for 3D buffers
 struct InitializeBufferKernel
 {
+    //! cost per cell for the roofline, the value is only written, see analyticalSolutionFlops
+    static constexpr double bytesPerCell = sizeof(double);
+    static constexpr double flopsPerCell = analyticalSolutionFlops + 2.0;
+
     template<typename TAcc, typename TMdSpan>
     ALPAKA_FN_ACC auto operator()(TAcc const& acc, TMdSpan bufData, double dx, double dy) const -> void
     {
         // Get indexes
         auto const gridThreadIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
 
-        bufData(gridThreadIdx[0], gridThreadIdx[1])
-            = analyticalSolution(acc, gridThreadIdx[1] * dx, gridThreadIdx[0] * dy, 0.0);
+        // a buffer of {E, Y, X} cells holds an ensemble of E simulations, all members start from the same values
+        if constexpr(TMdSpan::rank() == 3)
+        {
+            bufData(gridThreadIdx[0], gridThreadIdx[1], gridThreadIdx[2])
+                = analyticalSolution(acc, gridThreadIdx[2] * dx, gridThreadIdx[1] * dy, 0.0);
+        }
+        else
+        {
+            bufData(gridThreadIdx[0], gridThreadIdx[1])
+                = analyticalSolution(acc, gridThreadIdx[1] * dx, gridThreadIdx[0] * dy, 0.0);
+        }
+    }
+
+    template<typename TAcc, typename TMdSpan>
+    ALPAKA_FN_ACC auto operator()(TAcc const& acc, TMdSpan bufData, double dx, double dy, double dz) const -> void
+    {
+        // Get indexes
+        auto const gridThreadIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        bufData(gridThreadIdx[0], gridThreadIdx[1], gridThreadIdx[2]) = analyticalSolution(
+            acc,
+            gridThreadIdx[2] * dx,
+            gridThreadIdx[1] * dy,
+            gridThreadIdx[0] * dz,
+            0.0);
     }
 };
@@ -0,0 +1,26 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "conductivity.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+//! Fills the conductivity buffer with the conductivity field of the material, including the halo cells
+//!
+//! \param kBuf grid values of the conductivity k for each x, y pair
+//! \param dx step in x
+//! \param dy step in y
+struct InitializeConductivityKernel
+{
+    template<typename TAcc, typename TMdSpan>
+    ALPAKA_FN_ACC auto operator()(TAcc const& acc, TMdSpan kBuf, double dx, double dy) const -> void
+    {
+        // Get indexes
+        auto const gridThreadIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+
+        kBuf(gridThreadIdx[0], gridThreadIdx[1]) = conductivity(gridThreadIdx[1] * dx, gridThreadIdx[0] * dy);
+    }
+};
@@ -0,0 +1,205 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+//! Reduces one value per thread of the block with a binary operation
+//!
+//! Has to be called by all threads of the block, as it synchronizes them.
+//!
+//! \param sdata shared memory buffer with at least one element per thread of the block
+//! \param value contribution of the calling thread
+//! \param op associative and commutative binary operation
+//! \return the reduced value of the block in thread 0, the return value of the other threads is unspecified
+template<typename TAcc, typename TOp>
+ALPAKA_FN_ACC auto blockReduce(TAcc const& acc, double* const sdata, double const value, TOp const& op) -> double
+{
+    auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+    auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+    auto const blockThreadIdx1D = alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u];
+    auto const numBlockThreads = blockThreadExtent.prod();
+
+    sdata[blockThreadIdx1D] = value;
+
+    alpaka::syncBlockThreads(acc);
+
+    // tree reduction in shared memory, the number of threads does not have to be a power of two
+    alpaka::Idx<TAcc> activeThreads = 1;
+    while(activeThreads < numBlockThreads)
+    {
+        activeThreads *= 2;
+    }
+    for(auto stride = activeThreads / 2; stride > 0; stride /= 2)
+    {
+        if(blockThreadIdx1D < stride && blockThreadIdx1D + stride < numBlockThreads)
+        {
+            sdata[blockThreadIdx1D] = op(sdata[blockThreadIdx1D], sdata[blockThreadIdx1D + stride]);
+        }
+        alpaka::syncBlockThreads(acc);
+    }
+
+    return sdata[0];
+}
+
+//! Sums up one value per thread of the block and adds the block sum atomically to result
+//!
+//! Has to be called by all threads of the block, as it synchronizes them.
+//!
+//! \tparam T_BlockSize1D maximum number of threads in a block (size of the shared reduction buffer)
+//!
+//! \param result pointer to a single value in device memory
+//! \param value contribution of the calling thread
+template<size_t T_BlockSize1D, typename TAcc>
+ALPAKA_FN_ACC auto atomicAddBlockSum(TAcc const& acc, double* const result, double const value) -> void
+{
+    auto& sdata = alpaka::declareSharedVar<double[T_BlockSize1D], __COUNTER__>(acc);
+
+    double const blockSum = blockReduce(acc, sdata, value, [](double const a, double const b) { return a + b; });
+
+    auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+    auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+    if(alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u] == 0)
+    {
+        alpaka::atomicAdd(acc, result, blockSum);
+    }
+}
+
+//! Dot product of two grid functions restricted to the core cells
+//!
+//! Every block reduces its chunk in shared memory and adds the partial sum atomically to the result.
+//!
+//! \tparam T_BlockSize1D maximum number of threads in a block (size of the shared reduction buffer)
+//!
+//! \param xBuf first operand
+//! \param yBuf second operand
+//! \param result pointer to a single value in device memory, has to be zeroed before the launch
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+template<size_t T_BlockSize1D>
+struct DotProductKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan xBuf,
+        TMdSpan yBuf,
+        double* const result,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize) const -> void
+    {
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // every thread sums up its share of the core cells of the chunk
+        double threadSum = 0.0;
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                auto const globalIdx = alpaka::Vec(i, j) + haloSize + blockStartThreadIdx;
+                threadSum += xBuf(globalIdx[0], globalIdx[1]) * yBuf(globalIdx[0], globalIdx[1]);
+            }
+        }
+        atomicAddBlockSum<T_BlockSize1D>(acc, result, threadSum);
+    }
+};
+
+//! Scaled vector addition w = a * x + b * y on the core cells
+//!
+//! The output may alias one of the inputs. Halo cells of w are not touched.
+//!
+//! \param wBuf result
+//! \param xBuf first operand
+//! \param yBuf second operand
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param a factor of x
+//! \param b factor of y
+struct WaxpbyKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan wBuf,
+        TMdSpan xBuf,
+        TMdSpan yBuf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const a,
+        double const b) const -> void
+    {
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                auto const globalIdx = alpaka::Vec(i, j) + haloSize + blockStartThreadIdx;
+                wBuf(globalIdx[0], globalIdx[1])
+                    = a * xBuf(globalIdx[0], globalIdx[1]) + b * yBuf(globalIdx[0], globalIdx[1]);
+            }
+        }
+    }
+};
+
+//! Launches the DotProductKernel and waits for the result on the host
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_BlockSize1D maximum number of threads in a block
+template<typename TAcc, size_t T_BlockSize1D>
+class DotProduct
+{
+public:
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+
+    explicit DotProduct(DevAcc const& devAcc)
+        : m_resultAcc(alpaka::allocBuf<double, Idx>(devAcc, Idx{1}))
+        , m_resultHost(alpaka::allocBuf<double, Idx>(alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0), Idx{1}))
+    {
+    }
+
+    //! Dot product of the core cells of xBuf and yBuf, blocks until the queue is finished
+    template<typename TQueue, typename TWorkDiv, typename TBuf, typename TVec>
+    auto operator()(
+        TQueue& queue,
+        TWorkDiv const& workDiv,
+        TBuf& xBuf,
+        TBuf& yBuf,
+        TVec const& chunkSize,
+        TVec const& haloSize) -> double
+    {
+        alpaka::memset(queue, m_resultAcc, 0);
+        alpaka::exec<TAcc>(
+            queue,
+            workDiv,
+            m_dotProductKernel,
+            alpaka::experimental::getMdSpan(xBuf),
+            alpaka::experimental::getMdSpan(yBuf),
+            alpaka::getPtrNative(m_resultAcc),
+            chunkSize,
+            haloSize);
+        alpaka::memcpy(queue, m_resultHost, m_resultAcc);
+        alpaka::wait(queue);
+        return *alpaka::getPtrNative(m_resultHost);
+    }
+
+private:
+    DotProductKernel<T_BlockSize1D> m_dotProductKernel;
+    alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx> m_resultAcc;
+    alpaka::Buf<alpaka::DevCpu, double, alpaka::DimInt<1u>, Idx> m_resultHost;
+};
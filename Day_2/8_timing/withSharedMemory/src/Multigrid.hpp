@@ -0,0 +1,281 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "LinearAlgebraKernels.hpp"
+#include "MultigridKernels.hpp"
+#include "StencilKernel.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+//! Geometric multigrid for the implicit heat equation step (I - theta * dt * L) x = b
+//!
+//! Every coarser level halves the number of core cells per dimension and doubles the grid spacing, until the core no
+//! longer splits into chunks of two. A V-cycle smoothes with weighted Jacobi, restricts the residual, recurses and
+//! adds the prolongated correction. All levels use the chunk tiling and halo layout of the StencilKernel.
+//!
+//! The class can be used as a standalone solver (solve) or as a preconditioner of the ConjugateGradient (apply). With
+//! the same number of pre- and post-smoothing sweeps the V-cycle is symmetric, as required for preconditioning.
+//!
+//! Only the five-point stencil is supported, the smoother and the transfer operators assume a halo of one cell.
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_SharedMemSize1D size of the shared memory box of the StencilKernel
+//! \tparam T_BlockSize1D maximum number of threads in a block, used for the block reduction
+template<typename TAcc, size_t T_SharedMemSize1D, size_t T_BlockSize1D>
+class Multigrid
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using BufAcc = alpaka::Buf<DevAcc, double, Dim, Idx>;
+    using WorkDiv = alpaka::WorkDivMembers<Dim, Idx>;
+
+    //! \param devAcc device the level buffers are allocated on
+    //! \param numNodes number of core cells of the finest grid
+    //! \param threadsPerBlock threads per block of the work divisions
+    //! \param chunkSize size of the chunk handled by one block
+    //! \param haloSize size of the halo in {Y, X}
+    //! \param dx step in x on the finest grid
+    //! \param dy step in y on the finest grid
+    //! \param thetaDt implicit part of the time step, theta * dt
+    //! \param tolerance relative residual norm at which the standalone solver stops
+    //! \param maxCycles upper limit of V-cycles per standalone solve
+    Multigrid(
+        DevAcc const& devAcc,
+        alpaka::Vec<Dim, Idx> const& numNodes,
+        alpaka::Vec<Dim, Idx> const& threadsPerBlock,
+        alpaka::Vec<Dim, Idx> const& chunkSize,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const thetaDt,
+        double const tolerance = 1e-10,
+        uint32_t const maxCycles = 100)
+        : m_dot(devAcc)
+        , m_chunkSize(chunkSize)
+        , m_haloSize(haloSize)
+        , m_thetaDt(thetaDt)
+        , m_tolerance(tolerance)
+        , m_maxCycles(maxCycles)
+    {
+        constexpr alpaka::Vec<Dim, Idx> elemPerThread{1, 1};
+
+        auto levelNumNodes = numNodes;
+        double levelDx = dx;
+        double levelDy = dy;
+        while(true)
+        {
+            auto const numChunks = levelNumNodes / chunkSize;
+            auto const levelExtent = levelNumNodes + haloSize + haloSize;
+            Level level{
+                levelNumNodes,
+                levelDx,
+                levelDy,
+                WorkDiv{numChunks, threadsPerBlock, elemPerThread},
+                alpaka::allocBuf<double, Idx>(devAcc, levelExtent),
+                std::nullopt,
+                std::nullopt};
+            // the finest level works on the buffers passed in by the caller
+            if(!m_levels.empty())
+            {
+                level.eBuf.emplace(alpaka::allocBuf<double, Idx>(devAcc, levelExtent));
+                level.bBuf.emplace(alpaka::allocBuf<double, Idx>(devAcc, levelExtent));
+            }
+            m_levels.push_back(std::move(level));
+
+            // coarsen as long as the coarse core still consists of whole chunks
+            if(levelNumNodes[0] % (2 * chunkSize[0]) != 0 || levelNumNodes[1] % (2 * chunkSize[1]) != 0)
+                break;
+            levelNumNodes = levelNumNodes / alpaka::Vec<Dim, Idx>{2, 2};
+            levelDx *= 2.0;
+            levelDy *= 2.0;
+        }
+    }
+
+    //! Number of grid levels including the finest one
+    auto numLevels() const -> size_t
+    {
+        return m_levels.size();
+    }
+
+    //! Standalone solver, x holds the initial guess and the boundary values on entry and the solution on exit
+    //!
+    //! \return number of V-cycles
+    template<typename TQueue>
+    auto solve(TQueue& queue, BufAcc& xBuf, BufAcc& bBuf) -> uint32_t
+    {
+        auto& finest = m_levels.front();
+        double const bNorm = std::sqrt(dot(queue, finest, bBuf, bBuf));
+
+        uint32_t cycle = 0;
+        while(cycle < m_maxCycles)
+        {
+            residual(queue, finest, xBuf, bBuf);
+            if(std::sqrt(dot(queue, finest, finest.tmpBuf, finest.tmpBuf)) <= m_tolerance * bNorm)
+                break;
+            vCycle(queue, 0, xBuf, bBuf);
+            ++cycle;
+        }
+        return cycle;
+    }
+
+    //! Preconditioner z = M^-1 r, a single V-cycle with zero initial guess
+    template<typename TQueue>
+    auto apply(TQueue& queue, BufAcc& rBuf, BufAcc& zBuf) -> void
+    {
+        alpaka::memset(queue, zBuf, 0);
+        vCycle(queue, 0, zBuf, rBuf);
+    }
+
+private:
+    struct Level
+    {
+        alpaka::Vec<Dim, Idx> numNodes;
+        double dx;
+        double dy;
+        WorkDiv workDiv;
+        //! Jacobi ping-pong partner and residual
+        BufAcc tmpBuf;
+        //! correction and right hand side of the coarse levels
+        std::optional<BufAcc> eBuf;
+        std::optional<BufAcc> bBuf;
+    };
+
+    //! One V-cycle on level l for the approximation eBuf and the right hand side bBuf
+    template<typename TQueue>
+    auto vCycle(TQueue& queue, size_t const l, BufAcc& eBuf, BufAcc& bBuf) -> void
+    {
+        auto& level = m_levels[l];
+        if(l + 1 == m_levels.size())
+        {
+            smooth(queue, level, eBuf, bBuf, m_coarsestSweepPairs);
+            return;
+        }
+
+        smooth(queue, level, eBuf, bBuf, m_sweepPairs);
+
+        // restrict the residual to the right hand side of the coarse level, starting from a zero correction
+        residual(queue, level, eBuf, bBuf);
+        auto& coarse = m_levels[l + 1];
+        alpaka::exec<TAcc>(
+            queue,
+            coarse.workDiv,
+            m_restrictionKernel,
+            alpaka::experimental::getMdSpan(level.tmpBuf),
+            alpaka::experimental::getMdSpan(*coarse.bBuf),
+            m_chunkSize,
+            m_haloSize,
+            level.numNodes);
+        alpaka::memset(queue, *coarse.eBuf, 0);
+
+        vCycle(queue, l + 1, *coarse.eBuf, *coarse.bBuf);
+
+        alpaka::exec<TAcc>(
+            queue,
+            level.workDiv,
+            m_prolongationKernel,
+            alpaka::experimental::getMdSpan(*coarse.eBuf),
+            alpaka::experimental::getMdSpan(eBuf),
+            m_chunkSize,
+            m_haloSize,
+            coarse.numNodes);
+
+        smooth(queue, level, eBuf, bBuf, m_sweepPairs);
+    }
+
+    //! Pairs of Jacobi sweeps eBuf -> tmpBuf -> eBuf, so the result ends up in eBuf
+    template<typename TQueue>
+    auto smooth(TQueue& queue, Level& level, BufAcc& eBuf, BufAcc& bBuf, uint32_t const numSweepPairs) -> void
+    {
+        // the ping-pong partner needs the boundary values in its halo
+        alpaka::memcpy(queue, level.tmpBuf, eBuf);
+        for(uint32_t sweep = 0; sweep < numSweepPairs; ++sweep)
+        {
+            jacobi(queue, level, eBuf, level.tmpBuf, bBuf);
+            jacobi(queue, level, level.tmpBuf, eBuf, bBuf);
+        }
+    }
+
+    template<typename TQueue>
+    auto jacobi(TQueue& queue, Level& level, BufAcc& eInBuf, BufAcc& eOutBuf, BufAcc& bBuf) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            level.workDiv,
+            m_jacobiKernel,
+            alpaka::experimental::getMdSpan(eInBuf),
+            alpaka::experimental::getMdSpan(eOutBuf),
+            alpaka::experimental::getMdSpan(bBuf),
+            m_chunkSize,
+            m_haloSize,
+            level.dx,
+            level.dy,
+            m_thetaDt,
+            m_omega);
+    }
+
+    //! tmpBuf = b - A e on the core cells
+    template<typename TQueue>
+    auto residual(TQueue& queue, Level& level, BufAcc& eBuf, BufAcc& bBuf) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            level.workDiv,
+            m_stencilKernel,
+            alpaka::experimental::getMdSpan(eBuf),
+            alpaka::experimental::getMdSpan(level.tmpBuf),
+            m_chunkSize,
+            m_haloSize,
+            level.dx,
+            level.dy,
+            -m_thetaDt);
+        alpaka::exec<TAcc>(
+            queue,
+            level.workDiv,
+            m_waxpbyKernel,
+            alpaka::experimental::getMdSpan(level.tmpBuf),
+            alpaka::experimental::getMdSpan(bBuf),
+            alpaka::experimental::getMdSpan(level.tmpBuf),
+            m_chunkSize,
+            m_haloSize,
+            1.0,
+            -1.0);
+    }
+
+    template<typename TQueue>
+    auto dot(TQueue& queue, Level& level, BufAcc& xBuf, BufAcc& yBuf) -> double
+    {
+        return m_dot(queue, level.workDiv, xBuf, yBuf, m_chunkSize, m_haloSize);
+    }
+
+    StencilKernel<T_SharedMemSize1D> m_stencilKernel;
+    JacobiKernel<T_SharedMemSize1D> m_jacobiKernel;
+    RestrictionKernel m_restrictionKernel;
+    ProlongationKernel m_prolongationKernel;
+    WaxpbyKernel m_waxpbyKernel;
+
+    std::vector<Level> m_levels;
+    DotProduct<TAcc, T_BlockSize1D> m_dot;
+
+    alpaka::Vec<Dim, Idx> m_chunkSize;
+    alpaka::Vec<Dim, Idx> m_haloSize;
+    double m_thetaDt;
+    double m_tolerance;
+    uint32_t m_maxCycles;
+
+    //! damping of the Jacobi smoother, 4/5 is optimal for the five-point stencil
+    double m_omega = 0.8;
+    //! pre- and post-smoothing sweeps per level are twice this number
+    uint32_t m_sweepPairs = 1;
+    //! the coarsest level is solved approximately by Jacobi only
+    uint32_t m_coarsestSweepPairs = 16;
+};
@@ -0,0 +1,203 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+//! Weighted Jacobi sweep for (I - thetaDt * L) e = b
+//!
+//! \tparam T_SharedMemSize1D size of the shared memory box
+//!
+//! Uses the same shared memory tiling as the StencilKernel. Only the core cells of eOutBuf are written.
+//!
+//! \param eInBuf current approximation, the halo cells hold the boundary values
+//! \param eOutBuf next approximation
+//! \param bBuf right hand side
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param dx step in x
+//! \param dy step in y
+//! \param thetaDt implicit part of the time step
+//! \param omega damping factor of the Jacobi iteration
+template<size_t T_SharedMemSize1D>
+struct JacobiKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan eInBuf,
+        TMdSpan eOutBuf,
+        TMdSpan bBuf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const thetaDt,
+        double const omega) const -> void
+    {
+        auto& sdata = alpaka::declareSharedVar<double[T_SharedMemSize1D], __COUNTER__>(acc);
+        auto smemSize2D = chunkSize + haloSize + haloSize;
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        double const rX = thetaDt / (dx * dx);
+        double const rY = thetaDt / (dy * dy);
+        double const diagonal = 1.0 + 2.0 * rX + 2.0 * rY;
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // fill shared memory
+        for(auto i = blockThreadIdx[0]; i < smemSize2D[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < smemSize2D[1]; j += blockThreadExtent[1])
+            {
+                auto localIdx2D = alpaka::Vec(i, j);
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto globalIdx = localIdx2D + blockStartThreadIdx;
+                sdata[localIdx1D] = eInBuf(globalIdx[0], globalIdx[1]);
+            }
+        }
+
+        alpaka::syncBlockThreads(acc);
+
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                auto localIdx2D = alpaka::Vec(i, j) + haloSize;
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto const globalIdx = localIdx2D + blockStartThreadIdx;
+
+                double const ae = sdata[localIdx1D] * diagonal - (sdata[localIdx1D - 1] + sdata[localIdx1D + 1]) * rX
+                                  - (sdata[localIdx1D - smemSize2D[1]] + sdata[localIdx1D + smemSize2D[1]]) * rY;
+                eOutBuf(globalIdx[0], globalIdx[1])
+                    = sdata[localIdx1D] + omega * (bBuf(globalIdx[0], globalIdx[1]) - ae) / diagonal;
+            }
+        }
+    }
+};
+
+//! Restriction of the core cells of a fine grid function to the next coarser grid
+//!
+//! Every coarse cell covers 2x2 fine cells. The weights are the transpose of the bilinear ProlongationKernel divided
+//! by four, so a V-cycle stays symmetric and can precondition the conjugate gradient solver. Fine cells outside of
+//! the core do not contribute.
+//!
+//! \param fineBuf fine grid function
+//! \param coarseBuf coarse grid function, only the core cells are written
+//! \param chunkSize size of the chunk handled by one block on the coarse grid
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param fineNumNodes number of core cells of the fine grid
+struct RestrictionKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan fineBuf,
+        TMdSpan coarseBuf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        alpaka::Vec<TDim, TIdx> const& fineNumNodes) const -> void
+    {
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // 1D weights of the fine cells 2c-1, 2c, 2c+1, 2c+2 for coarse cell c
+        constexpr double weights[4] = {1.0 / 8.0, 3.0 / 8.0, 3.0 / 8.0, 1.0 / 8.0};
+
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                // core index of the coarse cell
+                auto const coarseIdx = alpaka::Vec(i, j) + blockStartThreadIdx;
+
+                double sum = 0.0;
+                for(int a = 0; a < 4; ++a)
+                {
+                    // fine core index, shifted by one so that cells outside of the core are negative
+                    auto const fineY = static_cast<int>(2 * coarseIdx[0]) - 1 + a;
+                    if(fineY < 0 || fineY >= static_cast<int>(fineNumNodes[0]))
+                        continue;
+                    for(int b = 0; b < 4; ++b)
+                    {
+                        auto const fineX = static_cast<int>(2 * coarseIdx[1]) - 1 + b;
+                        if(fineX < 0 || fineX >= static_cast<int>(fineNumNodes[1]))
+                            continue;
+                        auto const fineIdx
+                            = alpaka::Vec(static_cast<TIdx>(fineY), static_cast<TIdx>(fineX)) + haloSize;
+                        sum += weights[a] * weights[b] * fineBuf(fineIdx[0], fineIdx[1]);
+                    }
+                }
+                coarseBuf(coarseIdx[0] + haloSize[0], coarseIdx[1] + haloSize[1]) = sum;
+            }
+        }
+    }
+};
+
+//! Bilinear prolongation of a coarse grid function, added to the core cells of the fine grid
+//!
+//! Every fine cell interpolates from its parent coarse cell and the three nearest coarse neighbours with the weights
+//! 9/16, 3/16, 3/16 and 1/16. Coarse cells outside of the core do not contribute.
+//!
+//! \param coarseBuf coarse grid function
+//! \param fineBuf fine grid function, the interpolated values are added to its core cells
+//! \param chunkSize size of the chunk handled by one block on the fine grid
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param coarseNumNodes number of core cells of the coarse grid
+struct ProlongationKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan coarseBuf,
+        TMdSpan fineBuf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        alpaka::Vec<TDim, TIdx> const& coarseNumNodes) const -> void
+    {
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                // core index of the fine cell and its parent
+                auto const fineIdx = alpaka::Vec(i, j) + blockStartThreadIdx;
+                int const parentY = static_cast<int>(fineIdx[0] / 2);
+                int const parentX = static_cast<int>(fineIdx[1] / 2);
+                // the nearest coarse neighbour lies on the side of the fine cell within its parent
+                int const neighbourY = fineIdx[0] % 2 == 0 ? parentY - 1 : parentY + 1;
+                int const neighbourX = fineIdx[1] % 2 == 0 ? parentX - 1 : parentX + 1;
+
+                auto coarseValue = [&](int const y, int const x) -> double
+                {
+                    if(y < 0 || y >= static_cast<int>(coarseNumNodes[0]) || x < 0
+                       || x >= static_cast<int>(coarseNumNodes[1]))
+                        return 0.0;
+                    return coarseBuf(static_cast<TIdx>(y) + haloSize[0], static_cast<TIdx>(x) + haloSize[1]);
+                };
+
+                fineBuf(fineIdx[0] + haloSize[0], fineIdx[1] + haloSize[1])
+                    += (9.0 * coarseValue(parentY, parentX) + 3.0 * coarseValue(neighbourY, parentX)
+                        + 3.0 * coarseValue(parentY, neighbourX) + coarseValue(neighbourY, neighbourX))
+                       / 16.0;
+            }
+        }
+    }
+};
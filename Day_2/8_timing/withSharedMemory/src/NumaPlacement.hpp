@@ -0,0 +1,144 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "NumaPlacementKernels.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#    include <sched.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+#if defined(_OPENMP)
+#    include <omp.h>
+#endif
+
+//! Pins the OpenMP threads, thread i to the i-th CPU the process is allowed to run on
+//!
+//! The threads of the CpuOmp2Blocks accelerator are reused by all kernels, so the pinning holds for the whole
+//! simulation and the blocks of every kernel run on the same CPUs as long as the work division does not change. The
+//! CpuThreads accelerator starts new threads for every kernel, they can only be bound from the outside, e.g. with
+//! numactl --cpunodebind.
+//!
+//! \return number of pinned threads, 0 without OpenMP or on other operating systems than Linux
+inline auto pinOpenMpThreads() -> int
+{
+    int numPinnedThreads = 0;
+#if defined(_OPENMP) && defined(__linux__)
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+        return 0;
+    std::vector<int> cpus;
+    for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if(CPU_ISSET(cpu, &allowed))
+            cpus.push_back(cpu);
+    }
+
+#    pragma omp parallel reduction(+ : numPinnedThreads)
+    {
+        cpu_set_t pinned;
+        CPU_ZERO(&pinned);
+        CPU_SET(cpus[static_cast<std::size_t>(omp_get_thread_num()) % cpus.size()], &pinned);
+        if(sched_setaffinity(0, sizeof(pinned), &pinned) == 0)
+            ++numPinnedThreads;
+    }
+#endif
+    return numPinnedThreads;
+}
+
+//! Prints the NUMA nodes of the pages of a 2D grid on a CPU device
+//!
+//! Every page is expected on the node of the thread that updates the chunk of its first cell, the halo cells and the
+//! padding of the rows belong to the nearest chunk. Pages that were never touched are not placed yet.
+//!
+//! \param name name of the grid in the report
+//! \param grid view of the grid of {Y, X} cells
+//! \param numChunks number of chunks in {Y, X}
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param chunkNodes node of the thread of every chunk, row-major over the chunks, see ThreadNodeKernel
+template<typename TView, typename TDim, typename TIdx>
+auto reportNumaPlacement(
+    std::string const& name,
+    TView const& grid,
+    alpaka::Vec<TDim, TIdx> const& numChunks,
+    alpaka::Vec<TDim, TIdx> const& chunkSize,
+    alpaka::Vec<TDim, TIdx> const& haloSize,
+    int const* const chunkNodes) -> void
+{
+#if defined(__linux__) && defined(SYS_move_pages)
+    auto const extents = alpaka::getExtents(grid);
+    auto const elemSize = sizeof(*alpaka::getPtrNative(grid));
+    auto const rowPitch = static_cast<std::uintptr_t>(alpaka::getPitchesInBytes(grid)[0]);
+    auto const begin = reinterpret_cast<std::uintptr_t>(alpaka::getPtrNative(grid));
+    auto const end = begin + (extents[0] - 1) * rowPitch + extents[1] * elemSize;
+    auto const pageSize = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+
+    // chunk of a cell in dimension d, the halo belongs to the chunks at the border
+    auto const chunkOf = [&](std::uintptr_t const cell, unsigned const d) -> std::uintptr_t
+    {
+        auto const core = cell > haloSize[d] ? cell - haloSize[d] : 0;
+        return std::min<std::uintptr_t>(core / chunkSize[d], numChunks[d] - 1);
+    };
+
+    std::vector<void*> pages;
+    std::vector<int> expectedNodes;
+    for(auto page = begin / pageSize * pageSize; page < end; page += pageSize)
+    {
+        auto const offset = std::max(page, begin) - begin;
+        auto const row = offset / rowPitch;
+        auto const column = std::min<std::uintptr_t>((offset % rowPitch) / elemSize, extents[1] - 1);
+        pages.push_back(reinterpret_cast<void*>(page));
+        expectedNodes.push_back(chunkNodes[chunkOf(row, 0) * numChunks[1] + chunkOf(column, 1)]);
+    }
+
+    // with no target nodes move_pages only returns the node of every page, negative for pages not placed yet
+    std::vector<int> nodes(pages.size());
+    if(syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, nodes.data(), 0) != 0)
+    {
+        std::cout << "NUMA placement of " << name << " is not available." << std::endl;
+        return;
+    }
+
+    std::map<int, std::size_t> pagesPerNode;
+    std::size_t numLocalPages = 0;
+    std::size_t numUntouchedPages = 0;
+    for(std::size_t i = 0; i < pages.size(); ++i)
+    {
+        if(nodes[i] < 0)
+        {
+            ++numUntouchedPages;
+            continue;
+        }
+        ++pagesPerNode[nodes[i]];
+        if(nodes[i] == expectedNodes[i])
+            ++numLocalPages;
+    }
+
+    std::cout << "NUMA placement of " << name << ", " << pages.size() << " pages:";
+    for(auto const& [node, numPages] : pagesPerNode)
+        std::cout << " node " << node << ": " << numPages;
+    if(numUntouchedPages > 0)
+        std::cout << " not placed: " << numUntouchedPages;
+    std::cout << std::endl
+              << "  " << numLocalPages << " pages on the node of the thread that updates them" << std::endl;
+#else
+    std::cout << "NUMA placement of " << name << " is only available on Linux." << std::endl;
+#endif
+}
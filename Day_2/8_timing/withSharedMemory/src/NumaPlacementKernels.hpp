@@ -0,0 +1,89 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#if defined(__linux__)
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+//! NUMA node of the CPU the calling thread runs on, 0 if it is unknown
+inline auto currentNumaNode() -> int
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if(syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+        return static_cast<int>(node);
+#endif
+    return 0;
+}
+
+//! Writes zeros into a 2D grid with the mapping of blocks and threads of the StencilKernel
+//!
+//! Launched with the work division of the StencilKernel before anything else writes to the grid, every page is first
+//! touched and therefore placed on the NUMA node of the thread that later updates the chunk. The blocks at the border
+//! also touch the halo next to their chunk.
+//!
+//! \param buf grid of {Y, X} cells
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+struct FirstTouchKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan buf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize) const -> void
+    {
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const gridBlockExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // first and past the last cell of the chunk in dimension d, including the halo at the border of the grid
+        auto const begin = [&](unsigned const d) -> TIdx
+        { return gridBlockIdx[d] == 0 ? 0 : haloSize[d] + gridBlockIdx[d] * chunkSize[d]; };
+        auto const end = [&](unsigned const d) -> TIdx
+        {
+            return gridBlockIdx[d] + 1 == gridBlockExtent[d] ? static_cast<TIdx>(buf.extent(d))
+                                                             : haloSize[d] + (gridBlockIdx[d] + 1) * chunkSize[d];
+        };
+
+        for(auto i = begin(0) + blockThreadIdx[0]; i < end(0); i += blockThreadExtent[0])
+        {
+            for(auto j = begin(1) + blockThreadIdx[1]; j < end(1); j += blockThreadExtent[1])
+            {
+                buf(i, j) = 0.0;
+            }
+        }
+    }
+};
+
+//! Records the NUMA node of the thread that runs every block
+//!
+//! Launched with the work division of the StencilKernel it gives the node that updates every chunk. CPU accelerators
+//! only, the node is queried from the operating system.
+//!
+//! \param nodes node of every block, row-major over the blocks of the grid
+struct ThreadNodeKernel
+{
+    template<typename TAcc>
+    ALPAKA_FN_ACC auto operator()(TAcc const& acc, int* const nodes) const -> void
+    {
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const gridBlockExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        if(alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u] == 0)
+            nodes[alpaka::mapIdx<1>(gridBlockIdx, gridBlockExtent)[0u]] = currentNumaNode();
+    }
+};
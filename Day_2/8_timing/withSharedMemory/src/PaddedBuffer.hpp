@@ -0,0 +1,120 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+//! 2D grid buffer with padded rows
+//!
+//! \tparam TDev device the memory is allocated on
+//! \tparam TElem type of the elements
+//! \tparam TIdx index type
+//! \tparam T_Alignment alignment of the rows in bytes, e.g. the cache line or the SIMD width
+//!
+//! The row pitch is the width of the grid rounded up to a multiple of T_Alignment and the grid starts at an offset
+//! into the memory, so the first core cell of every row, the one after the left halo, is aligned. The memory is a 1D
+//! alpaka buffer and the grid is a pitched view into it. Views cannot be reassigned, so they are created on demand
+//! and the PaddedBuffer is the object that is swapped between the time steps.
+template<typename TDev, typename TElem, typename TIdx, std::size_t T_Alignment>
+class PaddedBuffer
+{
+    static_assert(
+        T_Alignment > 0 && T_Alignment % sizeof(TElem) == 0,
+        "The row alignment must be a multiple of the element size");
+
+public:
+    using Dim = alpaka::DimInt<2u>;
+    using Vec = alpaka::Vec<Dim, TIdx>;
+
+    static constexpr TIdx alignmentElems = static_cast<TIdx>(T_Alignment / sizeof(TElem));
+
+    //! \param dev device the memory is allocated on
+    //! \param extent extent of the grid in {Y, X} including the halo
+    //! \param haloX width of the halo to the left of the core
+    PaddedBuffer(TDev const& dev, Vec const& extent, TIdx const haloX)
+        : m_dev{dev}
+        , m_extent{extent}
+        , m_rowPitch{rowPitch(extent[1])}
+        , m_storage{alpaka::allocBuf<TElem, TIdx>(dev, static_cast<TIdx>(extent[0] * m_rowPitch + alignmentElems))}
+        , m_offset{alignedOffset(alpaka::getPtrNative(m_storage), haloX)}
+    {
+    }
+
+    //! Number of elements from the start of a row to the start of the next one
+    //!
+    //! \param width number of elements in a row
+    static constexpr auto rowPitch(TIdx const width) -> TIdx
+    {
+        return (width + alignmentElems - 1) / alignmentElems * alignmentElems;
+    }
+
+    //! Pitched view of the grid, it stays valid as long as the PaddedBuffer or one of its copies lives
+    auto getView()
+    {
+        return alpaka::createView(
+            m_dev,
+            alpaka::getPtrNative(m_storage) + m_offset,
+            m_extent,
+            Vec{static_cast<TIdx>(m_rowPitch * sizeof(TElem)), static_cast<TIdx>(sizeof(TElem))});
+    }
+
+    auto getMdSpan()
+    {
+        auto view = getView();
+        return alpaka::experimental::getMdSpan(view);
+    }
+
+private:
+    //! Offset in elements from the start of the memory, so that the cell (0, haloX) is aligned
+    static auto alignedOffset(TElem const* const memory, TIdx const haloX) -> TIdx
+    {
+        auto const misalignment = reinterpret_cast<std::uintptr_t>(memory + haloX) % T_Alignment;
+        return misalignment == 0 ? 0 : static_cast<TIdx>((T_Alignment - misalignment) / sizeof(TElem));
+    }
+
+    TDev m_dev;
+    Vec m_extent;
+    TIdx m_rowPitch;
+    alpaka::Buf<TDev, TElem, alpaka::DimInt<1u>, TIdx> m_storage;
+    TIdx m_offset;
+};
+
+//! The grid of a dense alpaka buffer is the buffer itself
+template<typename TBuf>
+auto getGridView(TBuf& buf) -> TBuf&
+{
+    return buf;
+}
+
+//! Pitched view of the grid of a PaddedBuffer
+template<typename TDev, typename TElem, typename TIdx, std::size_t T_Alignment>
+auto getGridView(PaddedBuffer<TDev, TElem, TIdx, T_Alignment>& buf)
+{
+    return buf.getView();
+}
+
+//! mdspan of the grid of a dense alpaka buffer, the kernels index it with the row pitch of the buffer
+template<typename TBuf>
+auto getGridMdSpan(TBuf& buf)
+{
+    return alpaka::experimental::getMdSpan(buf);
+}
+
+//! mdspan of the grid of a PaddedBuffer
+template<typename TDev, typename TElem, typename TIdx, std::size_t T_Alignment>
+auto getGridMdSpan(PaddedBuffer<TDev, TElem, TIdx, T_Alignment>& buf)
+{
+    return buf.getMdSpan();
+}
+
+//! Copies a grid into the row-major host buffer hostBuf
+template<typename TQueue, typename THostBuf, typename TBuf>
+auto copyGridToHost(TQueue& queue, THostBuf& hostBuf, TBuf& buf) -> void
+{
+    alpaka::memcpy(queue, hostBuf, getGridView(buf));
+}
@@ -0,0 +1,257 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#    include <linux/perf_event.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+#if defined(_OPENMP)
+#    include <omp.h>
+#endif
+
+//! Hardware event counts of an interval, scaled up if the kernel multiplexed the counters
+struct PerfCounts
+{
+    //! cycles, instructions, LLC load misses, LLC store misses, negative if the event is not available
+    std::array<double, 4> values{};
+    double seconds = 0.0;
+
+    auto operator-(PerfCounts const& other) const -> PerfCounts
+    {
+        PerfCounts difference;
+        for(std::size_t e = 0; e < values.size(); ++e)
+            difference.values[e] = values[e] < 0.0 ? -1.0 : values[e] - other.values[e];
+        difference.seconds = seconds - other.seconds;
+        return difference;
+    }
+
+    auto operator+=(PerfCounts const& other) -> PerfCounts&
+    {
+        for(std::size_t e = 0; e < values.size(); ++e)
+            values[e] = other.values[e] < 0.0 ? -1.0 : values[e] + other.values[e];
+        seconds += other.seconds;
+        return *this;
+    }
+};
+
+//! Hardware performance counters of the threads that run the kernels of the CPU accelerators
+//!
+//! Counts cycles, instructions and the load and store misses of the last level cache with perf_event_open in user
+//! space, which perf_event_paranoid <= 2 allows. Every OpenMP thread opens counters of its own, the main thread opens
+//! counters that the threads it starts later inherit, e.g. the threads of the CpuThreads accelerator. Inherited
+//! counts only arrive when a thread exits, so the counters are opened after the OpenMP threads and a long-lived
+//! thread pool is only measured through its own counters. Every line that misses the last level cache is moved
+//! to or from memory, the misses times the cache line size estimate the memory traffic.
+//!
+//! The counts are collected in named regions between begin and end, see report. HEAT_EQUATION_DISABLE_PERF_COUNTERS=1
+//! opens no counters, the report takes the path of a kernel that forbids counting.
+class PerfCounters
+{
+public:
+    static constexpr std::size_t numEvents = 4u;
+    static constexpr double cacheLineBytes = 64.0;
+
+    PerfCounters()
+    {
+#if defined(__linux__)
+        char const* const disable = std::getenv("HEAT_EQUATION_DISABLE_PERF_COUNTERS");
+        if(disable != nullptr && std::string{disable} == "1")
+            return;
+#    if defined(_OPENMP)
+#        pragma omp parallel
+        {
+            if(omp_get_thread_num() != 0)
+            {
+                auto const fds = openThreadCounters(false);
+#        pragma omp critical
+                m_fds.push_back(fds);
+            }
+        }
+#    endif
+        m_fds.push_back(openThreadCounters(true));
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#if defined(__linux__)
+        for(auto const& fds : m_fds)
+        {
+            for(int const fd : fds)
+            {
+                if(fd >= 0)
+                    close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(PerfCounters const&) = delete;
+    auto operator=(PerfCounters const&) -> PerfCounters& = delete;
+
+    //! Whether at least the cycles can be counted
+    auto available() const -> bool
+    {
+        return !m_fds.empty() && m_fds.back()[0] >= 0;
+    }
+
+    //! Sum of the counts of all threads since the counters were opened
+    auto read() const -> PerfCounts
+    {
+        PerfCounts counts;
+        counts.seconds
+            = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#if defined(__linux__)
+        for(std::size_t e = 0; e < numEvents; ++e)
+        {
+            for(auto const& fds : m_fds)
+            {
+                // value, time enabled and time running, the counter ran only part of the time if it was multiplexed
+                std::array<uint64_t, 3> data{};
+                if(fds[e] < 0 || ::read(fds[e], data.data(), sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+                {
+                    counts.values[e] = -1.0;
+                    break;
+                }
+                if(data[2] > 0)
+                    counts.values[e] += static_cast<double>(data[0]) * data[1] / data[2];
+            }
+        }
+#else
+        counts.values.fill(-1.0);
+#endif
+        return counts;
+    }
+
+    //! Starts the region name, the queue is waited for so that only the work enqueued afterwards is counted
+    template<typename TQueue>
+    auto begin(TQueue& queue, std::string const& name) -> void
+    {
+        alpaka::wait(queue);
+        region(name).start = read();
+    }
+
+    //! Ends the region name and adds the counts since begin, the queue is waited for
+    //!
+    //! \param numUpdates number of lattice updates since begin, e.g. the core cells of the grid for a kernel
+    template<typename TQueue>
+    auto end(TQueue& queue, std::string const& name, double const numUpdates) -> void
+    {
+        alpaka::wait(queue);
+        auto& counted = region(name);
+        counted.total += read() - counted.start;
+        counted.numUpdates += numUpdates;
+    }
+
+    //! Prints the counts of every region per lattice update next to the wall time
+    auto report() const -> void
+    {
+        if(!available())
+        {
+            std::cout << "Hardware performance counters are not available, see perf_event_paranoid." << std::endl;
+            return;
+        }
+        auto const precision = std::cout.precision(3);
+        std::cout << "Hardware performance counters per lattice update:" << std::endl;
+        for(auto const& [name, counted] : m_regions)
+        {
+            double const numUpdates = counted.numUpdates;
+            auto const& values = counted.total.values;
+            // the events that are not available are negative
+            auto const perUpdate = [&](double const value) -> std::string
+            { return value < 0.0 ? std::string{"n/a"} : formatValue(value / numUpdates); };
+            double const misses = values[2] < 0.0 ? -1.0 : values[2] + (values[3] > 0.0 ? values[3] : 0.0);
+
+            std::cout << "  " << name << ": " << counted.total.seconds / numUpdates * 1e9 << " ns, "
+                      << perUpdate(values[0]) << " cycles, " << perUpdate(values[1]) << " instructions";
+            if(values[0] > 0.0 && values[1] >= 0.0)
+                std::cout << " (IPC " << values[1] / values[0] << ")";
+            std::cout << ", " << perUpdate(misses) << " LLC misses, "
+                      << perUpdate(misses < 0.0 ? -1.0 : misses * cacheLineBytes) << " bytes of memory traffic";
+            if(misses >= 0.0)
+                std::cout << " (" << misses * cacheLineBytes / counted.total.seconds / 1e9 << " GB/s)";
+            std::cout << std::endl;
+        }
+        std::cout.precision(precision);
+    }
+
+private:
+    static auto formatValue(double const value) -> std::string
+    {
+        std::ostringstream stream;
+        stream << std::setprecision(3) << value;
+        return stream.str();
+    }
+
+    struct Region
+    {
+        PerfCounts start;
+        PerfCounts total;
+        double numUpdates = 0.0;
+    };
+
+    auto region(std::string const& name) -> Region&
+    {
+        for(auto& [regionName, counted] : m_regions)
+        {
+            if(regionName == name)
+                return counted;
+        }
+        m_regions.emplace_back(name, Region{});
+        return m_regions.back().second;
+    }
+
+#if defined(__linux__)
+    //! Opens the counters of the calling thread, -1 for the events the CPU or the kernel do not provide
+    //!
+    //! \param inherit whether the threads started later by the calling thread are counted as well
+    static auto openThreadCounters(bool const inherit) -> std::array<int, numEvents>
+    {
+        constexpr auto llcMiss = [](uint64_t const op) -> uint64_t
+        { return PERF_COUNT_HW_CACHE_LL | op << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16; };
+        std::array<std::pair<uint32_t, uint64_t>, numEvents> const events{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, llcMiss(PERF_COUNT_HW_CACHE_OP_READ)},
+            {PERF_TYPE_HW_CACHE, llcMiss(PERF_COUNT_HW_CACHE_OP_WRITE)},
+        }};
+
+        std::array<int, numEvents> fds{};
+        for(std::size_t e = 0; e < numEvents; ++e)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[e].first;
+            attr.config = events[e].second;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            attr.inherit = inherit ? 1u : 0u;
+            attr.exclude_kernel = 1u;
+            attr.exclude_hv = 1u;
+            fds[e] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+        return fds;
+    }
+#endif
+
+    std::vector<std::array<int, numEvents>> m_fds;
+    std::vector<std::pair<std::string, Region>> m_regions;
+};
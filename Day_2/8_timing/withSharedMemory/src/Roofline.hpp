@@ -0,0 +1,202 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "BandwidthProbe.hpp"
+#include "RooflineKernels.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+//! Analytic cost of a kernel per cell it updates
+//!
+//! The bytes are the compulsory traffic to global memory, every value read once and every result written once. The
+//! FLOPs count the arithmetic of a cell without the loop-invariant coefficients, a transcendental function counts as
+//! one FLOP.
+struct KernelCost
+{
+    double bytesPerCell;
+    double flopsPerCell;
+};
+
+//! Cost declared by a kernel with the static members bytesPerCell and flopsPerCell
+template<typename TKernel>
+constexpr auto kernelCost() -> KernelCost
+{
+    return {TKernel::bytesPerCell, TKernel::flopsPerCell};
+}
+
+//! Roofline model of the kernels on an accelerator
+//!
+//! The attainable memory bandwidth is the peak of the BandwidthProbe, the constructor probes the attainable FLOP rate
+//! with the MultiplyAddKernel, the best of a few runs. measure times a kernel over many launches, report prints the
+//! achieved arithmetic intensity of every kernel and the share of its roofline bound
+//!     min(attainable FLOP rate, arithmetic intensity * attainable bandwidth).
+//! Probe the bandwidth with arrays of the size of the timed grids, so the bound comes from the same level of the
+//! memory hierarchy as the traffic of the kernels.
+//!
+//! \tparam TAcc accelerator type
+template<typename TAcc>
+class Roofline
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using Vec = alpaka::Vec<Dim, Idx>;
+
+    static constexpr uint32_t numProbeRuns = 5u;
+    static constexpr uint32_t numKernelLaunches = 100u;
+
+    //! Kernel timed by measure or measureHost
+    struct Entry
+    {
+        std::string name;
+        KernelCost cost;
+        double numCells;
+        //! mean time of a launch
+        double seconds;
+        //! whether the kernel runs on the accelerator, otherwise it is a pass on the host
+        bool onAcc;
+    };
+
+    //! \param devAcc device of the accelerator
+    //! \param numProbeElements elements of each array of the bandwidth probe, e.g. the cells of the timed grid
+    Roofline(DevAcc const& devAcc, Idx const numProbeElements)
+        : m_devAcc{devAcc}
+        , m_numProbeElements{numProbeElements}
+    {
+        m_bandwidth = attainableBandwidth<TAcc>(devAcc, numProbeElements).peak();
+        probeFlops();
+    }
+
+    //! Times numKernelLaunches calls of launch, which enqueues the kernel into the queue
+    //!
+    //! \param name name of the kernel in the report
+    //! \param cost analytic cost of the kernel per cell, see kernelCost
+    //! \param numCells number of cells a launch updates
+    template<typename TQueue, typename TLaunch>
+    auto measure(
+        TQueue& queue,
+        std::string const& name,
+        KernelCost const& cost,
+        double const numCells,
+        TLaunch&& launch) -> void
+    {
+        double const seconds = timeLaunches(queue, numKernelLaunches, std::forward<TLaunch>(launch));
+        m_entries.push_back({name, cost, numCells, seconds, true});
+    }
+
+    //! Times numKernelLaunches calls of a pass on the host, the bound only applies if the accelerator is the host
+    template<typename TPass>
+    auto measureHost(std::string const& name, KernelCost const& cost, double const numCells, TPass&& pass) -> void
+    {
+        pass();
+        auto const start = std::chrono::high_resolution_clock::now();
+        for(uint32_t i = 0; i < numKernelLaunches; ++i)
+            pass();
+        std::chrono::duration<double> const elapsed = std::chrono::high_resolution_clock::now() - start;
+        m_entries.push_back({name, cost, numCells, elapsed.count() / numKernelLaunches, false});
+    }
+
+    //! The timed kernels in the order of their measurement
+    auto entries() const -> std::vector<Entry> const&
+    {
+        return m_entries;
+    }
+
+    //! Attainable memory bandwidth in bytes per second
+    auto bandwidth() const -> double
+    {
+        return m_bandwidth;
+    }
+
+    //! Attainable FLOP rate in FLOPs per second
+    auto flopRate() const -> double
+    {
+        return m_flopRate;
+    }
+
+    auto report() const -> void
+    {
+        auto const flags = std::cout.flags();
+        auto const precision = std::cout.precision(3);
+        std::cout << "Roofline, attainable " << m_bandwidth / 1e9 << " GB/s (STREAM on arrays of "
+                  << m_numProbeElements << " elements) and " << m_flopRate / 1e9 << " GFLOP/s (multiply-add):"
+                  << std::endl;
+        std::cout << std::left << std::setw(24) << "  kernel" << std::right << std::setw(12) << "time [us]"
+                  << std::setw(12) << "FLOP/byte" << std::setw(12) << "GB/s" << std::setw(12) << "GFLOP/s"
+                  << std::setw(14) << "% of bound" << std::endl;
+        for(auto const& entry : m_entries)
+        {
+            double const intensity = entry.cost.flopsPerCell / entry.cost.bytesPerCell;
+            double const bytesPerSecond = entry.cost.bytesPerCell * entry.numCells / entry.seconds;
+            double const flopsPerSecond = entry.cost.flopsPerCell * entry.numCells / entry.seconds;
+            std::cout << "  " << std::left << std::setw(22) << entry.name << std::right << std::setw(12)
+                      << entry.seconds * 1e6 << std::setw(12) << intensity << std::setw(12) << bytesPerSecond / 1e9
+                      << std::setw(12) << flopsPerSecond / 1e9 << std::setw(14);
+            // passes on the host are only bound by the roofline of a CPU accelerator
+            if(entry.onAcc || std::is_same_v<DevAcc, alpaka::DevCpu>)
+            {
+                double const bound = std::min(m_flopRate, intensity * m_bandwidth);
+                std::cout << 100.0 * flopsPerSecond / bound;
+            }
+            else
+                std::cout << "host";
+            std::cout << std::endl;
+        }
+        std::cout.precision(precision);
+        std::cout.flags(flags);
+    }
+
+private:
+    auto probeFlops() -> void
+    {
+        alpaka::Queue<TAcc, alpaka::Blocking> queue{m_devAcc};
+        constexpr uint32_t numIterations = 1u << 14;
+        Idx const numThreads = Idx{1} << 14;
+        auto result = alpaka::allocBuf<double, Idx>(m_devAcc, numThreads);
+
+        alpaka::KernelCfg<TAcc> const cfg{elementsPerDim(numThreads), Vec::ones()};
+        auto const workDiv
+            = alpaka::getValidWorkDiv(cfg, m_devAcc, MultiplyAddKernel{}, alpaka::getPtrNative(result), numIterations);
+
+        double bestSeconds = 0.0;
+        for(uint32_t run = 0; run <= numProbeRuns; ++run)
+        {
+            auto const start = std::chrono::high_resolution_clock::now();
+            alpaka::exec<TAcc>(queue, workDiv, MultiplyAddKernel{}, alpaka::getPtrNative(result), numIterations);
+            alpaka::wait(queue);
+            std::chrono::duration<double> const elapsed = std::chrono::high_resolution_clock::now() - start;
+            if(run == 1u || (run > 1u && elapsed.count() < bestSeconds))
+                bestSeconds = elapsed.count();
+        }
+        m_flopRate = 2.0 * MultiplyAddKernel::numChains * numIterations * static_cast<double>(numThreads)
+                     / bestSeconds;
+    }
+
+    //! Extent of numElements threads in the last dimension of the accelerator
+    static auto elementsPerDim(Idx const numElements) -> Vec
+    {
+        auto extent = Vec::ones();
+        extent[Dim::value - 1u] = numElements;
+        return extent;
+    }
+
+    DevAcc m_devAcc;
+    Idx m_numProbeElements;
+    double m_bandwidth = 0.0;
+    double m_flopRate = 0.0;
+    std::vector<Entry> m_entries;
+};
@@ -0,0 +1,46 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstdint>
+
+//! FLOP probe of the roofline, independent chains of multiply-adds in every thread
+//!
+//! The chains keep the pipelines of the floating point units busy, each iteration of a chain is one multiplication
+//! and one addition. The sum of the chains is written, so the compiler cannot drop them.
+//!
+//! \param result one element per thread
+//! \param numIterations number of iterations of every chain
+struct MultiplyAddKernel
+{
+    static constexpr uint32_t numChains = 8u;
+
+    template<typename TAcc>
+    ALPAKA_FN_ACC auto operator()(TAcc const& acc, double* const result, uint32_t const numIterations) const -> void
+    {
+        auto const gridThreadExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Threads>(acc);
+        auto const gridThreadIdx1D
+            = alpaka::mapIdx<1>(alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc), gridThreadExtent)[0u];
+
+        double chains[numChains];
+        for(uint32_t c = 0; c < numChains; ++c)
+            chains[c] = static_cast<double>(gridThreadIdx1D + c);
+        // a factor slightly below one keeps the values finite
+        double const factor = 0.999999;
+        double const summand = 1e-6;
+        for(uint32_t iteration = 0; iteration < numIterations; ++iteration)
+        {
+            for(uint32_t c = 0; c < numChains; ++c)
+                chains[c] = chains[c] * factor + summand;
+        }
+
+        double sum = 0.0;
+        for(uint32_t c = 0; c < numChains; ++c)
+            sum += chains[c];
+        result[gridThreadIdx1D] = sum;
+    }
+};
@@ -0,0 +1,336 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "RungeKuttaChebyshevKernels.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+//! Adaptive second order Runge-Kutta-Chebyshev (RKC) time stepping
+//!
+//! RKC is an explicit scheme whose stability region grows quadratically with the number of stages s, it covers
+//! dt * rho <= 0.653 * (s^2 - 1) for the spectral radius rho of the Laplacian. Every step chooses s from the stability
+//! bound and estimates the local error on the device. Steps with a weighted RMS error above one are rejected, and the
+//! next step size follows from the error estimate. As the solution decays, the estimate shrinks and the steps grow, so
+//! far fewer steps than with the forward Euler scheme are needed.
+//!
+//! The coefficients follow Sommeijer, Shampine and Verwer, "RKC: An explicit solver for parabolic PDEs" (1998).
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_SharedMemSize1D size of the shared memory box of the stage kernels
+//! \tparam T_BlockSize1D maximum number of threads in a block, used for the block reduction
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+template<typename TAcc, size_t T_SharedMemSize1D, size_t T_BlockSize1D, typename T_Stencil = FivePointStencil>
+class RungeKuttaChebyshev
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using BufAcc = alpaka::Buf<DevAcc, double, Dim, Idx>;
+    using WorkDiv = alpaka::WorkDivMembers<Dim, Idx>;
+
+    //! \param devAcc device the stage buffers are allocated on
+    //! \param extent extent of the grid including the halo
+    //! \param workDivCore work division with one block per chunk
+    //! \param chunkSize size of the chunk handled by one block
+    //! \param haloSize size of the halo in {Y, X}
+    //! \param dx step in x
+    //! \param dy step in y
+    //! \param dt initial step in t
+    //! \param tolerance absolute and relative tolerance of the local error
+    //! \param maxStages upper limit of stages per step, limits the step size via the stability bound
+    RungeKuttaChebyshev(
+        DevAcc const& devAcc,
+        alpaka::Vec<Dim, Idx> const& extent,
+        WorkDiv const& workDivCore,
+        alpaka::Vec<Dim, Idx> const& chunkSize,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt,
+        double const tolerance = 1e-5,
+        uint32_t const maxStages = 64)
+        : m_f0Buf(alpaka::allocBuf<double, Idx>(devAcc, extent))
+        , m_stageBufs{alpaka::allocBuf<double, Idx>(devAcc, extent), alpaka::allocBuf<double, Idx>(devAcc, extent)}
+        , m_errorAcc(alpaka::allocBuf<double, Idx>(devAcc, Idx{1}))
+        , m_errorHost(alpaka::allocBuf<double, Idx>(alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0), Idx{1}))
+        , m_workDivCore(workDivCore)
+        , m_chunkSize(chunkSize)
+        , m_haloSize(haloSize)
+        , m_numCells(static_cast<double>((extent - haloSize - haloSize).prod()))
+        , m_dx(dx)
+        , m_dy(dy)
+        , m_dt(dt)
+        , m_spectralRadius(T_Stencil::spectralRadius() * (1.0 / (dx * dx) + 1.0 / (dy * dy)))
+        , m_tolerance(tolerance)
+        , m_maxStages(maxStages)
+    {
+    }
+
+    //! Advance uCurr from time to uNext, the step size is chosen adaptively but does not go past tEnd
+    //!
+    //! Rejected steps are repeated with a smaller step size until one is accepted.
+    //!
+    //! \param workDivExtent work division covering the whole grid including the halo, as used by the boundary
+    //! \param boundary provider of the boundary values, see BoundaryConditions.hpp
+    //! \return time at the end of the accepted step
+    template<typename TQueue, typename TBoundary>
+    auto step(
+        TQueue& queue,
+        WorkDiv const& workDivExtent,
+        TBoundary& boundary,
+        BufAcc& uCurrBuf,
+        BufAcc& uNextBuf,
+        double const time,
+        double const tEnd) -> double
+    {
+        // f0 = L u(time)
+        exec(queue, uCurrBuf, uCurrBuf, uCurrBuf, uCurrBuf, m_f0Buf, 0.0, 0.0, 0.0, 1.0, 0.0);
+
+        while(true)
+        {
+            double const dt = std::min({m_dt, maxStableStep(), tEnd - time});
+            double const error = attempt(queue, workDivExtent, boundary, uCurrBuf, uNextBuf, time, dt);
+
+            // the error estimate is of third order in dt
+            double const factor = std::clamp(0.8 * std::cbrt(1.0 / std::max(error, 1e-10)), 0.1, 10.0);
+            if(error <= 1.0)
+            {
+                ++m_numAcceptedSteps;
+                // do not grow the step size right after a rejection
+                m_dt = m_previousStepRejected ? std::min(dt, dt * factor) : dt * factor;
+                m_previousStepRejected = false;
+                return dt == tEnd - time ? tEnd : time + dt;
+            }
+            ++m_numRejectedSteps;
+            m_dt = dt * factor;
+            m_previousStepRejected = true;
+        }
+    }
+
+    auto numAcceptedSteps() const -> uint32_t
+    {
+        return m_numAcceptedSteps;
+    }
+
+    auto numRejectedSteps() const -> uint32_t
+    {
+        return m_numRejectedSteps;
+    }
+
+    //! Number of stencil evaluations of all accepted and rejected steps
+    auto numStages() const -> uint32_t
+    {
+        return m_numStages;
+    }
+
+private:
+    //! One step of size dt from uCurr into uNext, returns the weighted RMS norm of the local error estimate
+    template<typename TQueue, typename TBoundary>
+    auto attempt(
+        TQueue& queue,
+        WorkDiv const& workDivExtent,
+        TBoundary& boundary,
+        BufAcc& uCurrBuf,
+        BufAcc& uNextBuf,
+        double const time,
+        double const dt) -> double
+    {
+        // number of stages required for stability, the damped scheme covers dt * rho <= 0.653 * (s^2 - 1)
+        auto const numStages = std::max(2u, 1u + static_cast<uint32_t>(std::sqrt(1.0 + 1.54 * dt * m_spectralRadius)));
+        computeCoefficients(numStages);
+        m_numStages += numStages;
+
+        // the last stage ends up in uNext, the others rotate through the stage buffers
+        auto stageBuf = [&](uint32_t const j) -> BufAcc&
+        {
+            if(j == 0)
+                return uCurrBuf;
+            auto const slot = (numStages - j) % 3u;
+            return slot == 0 ? uNextBuf : m_stageBufs[slot - 1];
+        };
+
+        for(uint32_t j = 1; j <= numStages; ++j)
+        {
+            auto const& c = m_coefficients[j];
+            // the first stage has no predecessor before y0, yPrevPrev is weighted with zero then
+            exec(
+                queue,
+                uCurrBuf,
+                stageBuf(j - 1),
+                stageBuf(j >= 2 ? j - 2 : 0),
+                m_f0Buf,
+                stageBuf(j),
+                1.0 - c.mu - c.nu,
+                c.mu,
+                c.nu,
+                c.muTilde * dt,
+                c.gammaTilde * dt);
+
+            // the halo holds the boundary values at the time of the stage
+            boundary.apply(
+                queue,
+                workDivExtent,
+                alpaka::experimental::getMdSpan(stageBuf(j)),
+                m_haloSize,
+                time + c.stageTime * dt);
+        }
+
+        alpaka::memset(queue, m_errorAcc, 0);
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            m_errorKernel,
+            alpaka::experimental::getMdSpan(uCurrBuf),
+            alpaka::experimental::getMdSpan(uNextBuf),
+            alpaka::experimental::getMdSpan(m_f0Buf),
+            alpaka::getPtrNative(m_errorAcc),
+            m_chunkSize,
+            m_haloSize,
+            m_dx,
+            m_dy,
+            dt,
+            m_tolerance,
+            m_tolerance);
+        alpaka::memcpy(queue, m_errorHost, m_errorAcc);
+        alpaka::wait(queue);
+        return std::sqrt(*alpaka::getPtrNative(m_errorHost) / m_numCells);
+    }
+
+    //! Largest step size that is stable with at most maxStages stages
+    auto maxStableStep() const -> double
+    {
+        double const s = static_cast<double>(m_maxStages - 1u);
+        return (s * s - 1.0) / (1.54 * m_spectralRadius);
+    }
+
+    //! Coefficients of the damped Chebyshev recurrence with s stages
+    auto computeCoefficients(uint32_t const numStages) -> void
+    {
+        if(numStages == m_numStagesOfCoefficients)
+            return;
+        m_numStagesOfCoefficients = numStages;
+        m_coefficients.assign(numStages + 1u, Coefficients{});
+
+        // Chebyshev polynomials T_j and their first two derivatives at w0
+        constexpr double damping = 2.0 / 13.0;
+        double const s = static_cast<double>(numStages);
+        double const w0 = 1.0 + damping / (s * s);
+        std::vector<double> t(numStages + 1u), dT(numStages + 1u), ddT(numStages + 1u);
+        t[0] = 1.0;
+        t[1] = w0;
+        dT[0] = 0.0;
+        dT[1] = 1.0;
+        ddT[0] = 0.0;
+        ddT[1] = 0.0;
+        for(uint32_t j = 2; j <= numStages; ++j)
+        {
+            t[j] = 2.0 * w0 * t[j - 1] - t[j - 2];
+            dT[j] = 2.0 * t[j - 1] + 2.0 * w0 * dT[j - 1] - dT[j - 2];
+            ddT[j] = 4.0 * dT[j - 1] + 2.0 * w0 * ddT[j - 1] - ddT[j - 2];
+        }
+        double const w1 = dT[numStages] / ddT[numStages];
+
+        // b_j = T_j'' / T_j'^2, with b_0 = b_1 = b_2
+        std::vector<double> b(numStages + 1u);
+        for(uint32_t j = 2; j <= numStages; ++j)
+            b[j] = ddT[j] / (dT[j] * dT[j]);
+        b[0] = b[1] = b[2];
+
+        m_coefficients[1].muTilde = b[1] * w1;
+        m_coefficients[1].stageTime = m_coefficients[1].muTilde;
+        for(uint32_t j = 2; j <= numStages; ++j)
+        {
+            auto& c = m_coefficients[j];
+            c.mu = 2.0 * w0 * b[j] / b[j - 1];
+            c.nu = -b[j] / b[j - 2];
+            c.muTilde = 2.0 * w1 * b[j] / b[j - 1];
+            c.gammaTilde = -(1.0 - b[j - 1] * t[j - 1]) * c.muTilde;
+            c.stageTime = c.mu * m_coefficients[j - 1].stageTime + c.nu * m_coefficients[j - 2].stageTime + c.muTilde
+                          + c.gammaTilde;
+        }
+    }
+
+    //! out = w0 * y0 + wPrev * yPrev + wPrevPrev * yPrevPrev + wLaplacePrev * L yPrev + wF0 * f0
+    template<typename TQueue>
+    auto exec(
+        TQueue& queue,
+        BufAcc& y0Buf,
+        BufAcc& yPrevBuf,
+        BufAcc& yPrevPrevBuf,
+        BufAcc& f0Buf,
+        BufAcc& outBuf,
+        double const w0,
+        double const wPrev,
+        double const wPrevPrev,
+        double const wLaplacePrev,
+        double const wF0) -> void
+    {
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            m_stageKernel,
+            alpaka::experimental::getMdSpan(y0Buf),
+            alpaka::experimental::getMdSpan(yPrevBuf),
+            alpaka::experimental::getMdSpan(yPrevPrevBuf),
+            alpaka::experimental::getMdSpan(f0Buf),
+            alpaka::experimental::getMdSpan(outBuf),
+            m_chunkSize,
+            m_haloSize,
+            m_dx,
+            m_dy,
+            w0,
+            wPrev,
+            wPrevPrev,
+            wLaplacePrev,
+            wF0);
+    }
+
+    //! Weights of stage j: y_j = (1 - mu - nu) y_0 + mu y_{j-1} + nu y_{j-2} + muTilde dt F_{j-1} + gammaTilde dt F_0
+    struct Coefficients
+    {
+        double mu = 0.0;
+        double nu = 0.0;
+        double muTilde = 0.0;
+        double gammaTilde = 0.0;
+        //! time of the stage as a fraction of dt
+        double stageTime = 0.0;
+    };
+
+    ChebyshevStageKernel<T_SharedMemSize1D, T_Stencil> m_stageKernel;
+    ChebyshevErrorKernel<T_SharedMemSize1D, T_BlockSize1D, T_Stencil> m_errorKernel;
+
+    BufAcc m_f0Buf;
+    std::array<BufAcc, 2> m_stageBufs;
+    alpaka::Buf<DevAcc, double, alpaka::DimInt<1u>, Idx> m_errorAcc;
+    alpaka::Buf<alpaka::DevCpu, double, alpaka::DimInt<1u>, Idx> m_errorHost;
+
+    std::vector<Coefficients> m_coefficients;
+    uint32_t m_numStagesOfCoefficients = 0;
+
+    WorkDiv m_workDivCore;
+    alpaka::Vec<Dim, Idx> m_chunkSize;
+    alpaka::Vec<Dim, Idx> m_haloSize;
+    double m_numCells;
+    double m_dx;
+    double m_dy;
+    //! step size of the next attempt
+    double m_dt;
+    double m_spectralRadius;
+    double m_tolerance;
+    uint32_t m_maxStages;
+
+    bool m_previousStepRejected = false;
+    uint32_t m_numAcceptedSteps = 0;
+    uint32_t m_numRejectedSteps = 0;
+    uint32_t m_numStages = 0;
+};
@@ -0,0 +1,193 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "LinearAlgebraKernels.hpp"
+#include "Stencil.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+//! One stage of the Runge-Kutta-Chebyshev recurrence
+//!
+//! \tparam T_SharedMemSize1D size of the shared memory box
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+//!
+//! Computes on the core cells
+//!     out = w0 * y0 + wPrev * yPrev + wPrevPrev * yPrevPrev + wLaplacePrev * L yPrev + wF0 * f0
+//! where L is the Laplacian of the stencil. yPrev is tiled in shared memory like in the StencilKernel, its halo cells
+//! have to hold the boundary values at the time of the previous stage. With all weights except wLaplacePrev set to
+//! zero the kernel evaluates the right hand side L yPrev.
+//!
+//! \param y0Buf values at the beginning of the step
+//! \param yPrevBuf values of the previous stage
+//! \param yPrevPrevBuf values of the stage before the previous one
+//! \param f0Buf right hand side at the beginning of the step, L y0
+//! \param outBuf values of the new stage
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param dx step in x
+//! \param dy step in y
+//! \param w0 weight of y0
+//! \param wPrev weight of yPrev
+//! \param wPrevPrev weight of yPrevPrev
+//! \param wLaplacePrev weight of L yPrev
+//! \param wF0 weight of f0
+template<size_t T_SharedMemSize1D, typename T_Stencil>
+struct ChebyshevStageKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan y0Buf,
+        TMdSpan yPrevBuf,
+        TMdSpan yPrevPrevBuf,
+        TMdSpan f0Buf,
+        TMdSpan outBuf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const w0,
+        double const wPrev,
+        double const wPrevPrev,
+        double const wLaplacePrev,
+        double const wF0) const -> void
+    {
+        auto& sdata = alpaka::declareSharedVar<double[T_SharedMemSize1D], __COUNTER__>(acc);
+        auto smemSize2D = chunkSize + haloSize + haloSize;
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        double const rX = 1.0 / (dx * dx);
+        double const rY = 1.0 / (dy * dy);
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // fill shared memory
+        for(auto i = blockThreadIdx[0]; i < smemSize2D[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < smemSize2D[1]; j += blockThreadExtent[1])
+            {
+                auto localIdx2D = alpaka::Vec(i, j);
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto globalIdx = localIdx2D + blockStartThreadIdx;
+                sdata[localIdx1D] = yPrevBuf(globalIdx[0], globalIdx[1]);
+            }
+        }
+
+        alpaka::syncBlockThreads(acc);
+
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                auto localIdx2D = alpaka::Vec(i, j) + haloSize;
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto const globalIdx = localIdx2D + blockStartThreadIdx;
+
+                double const laplace = T_Stencil::laplace(sdata, localIdx1D, smemSize2D[1], rX, rY);
+                outBuf(globalIdx[0], globalIdx[1])
+                    = w0 * y0Buf(globalIdx[0], globalIdx[1]) + wPrev * sdata[localIdx1D]
+                      + wPrevPrev * yPrevPrevBuf(globalIdx[0], globalIdx[1]) + wLaplacePrev * laplace
+                      + wF0 * f0Buf(globalIdx[0], globalIdx[1]);
+            }
+        }
+    }
+};
+
+//! Squared weighted norm of the local error estimate of a Runge-Kutta-Chebyshev step
+//!
+//! \tparam T_SharedMemSize1D size of the shared memory box
+//! \tparam T_BlockSize1D maximum number of threads in a block (size of the shared reduction buffer)
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+//!
+//! The error estimate of the second order scheme is
+//!     est = (12 * (y0 - y1) + 6 * dt * (L y0 + L y1)) / 15
+//! and every cell is weighted with 1 / (absTolerance + relTolerance * max(|y0|, |y1|)). The squares of the weighted
+//! estimates of the core cells are summed up atomically in result.
+//!
+//! \param y0Buf values at the beginning of the step
+//! \param y1Buf values at the end of the step, the halo cells have to hold the boundary values at the end of the step
+//! \param f0Buf right hand side at the beginning of the step, L y0
+//! \param result pointer to a single value in device memory, has to be zeroed before the launch
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param dx step in x
+//! \param dy step in y
+//! \param dt step in t
+//! \param absTolerance absolute error tolerance
+//! \param relTolerance relative error tolerance
+template<size_t T_SharedMemSize1D, size_t T_BlockSize1D, typename T_Stencil>
+struct ChebyshevErrorKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan y0Buf,
+        TMdSpan y1Buf,
+        TMdSpan f0Buf,
+        double* const result,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt,
+        double const absTolerance,
+        double const relTolerance) const -> void
+    {
+        auto& sdata = alpaka::declareSharedVar<double[T_SharedMemSize1D], __COUNTER__>(acc);
+        auto smemSize2D = chunkSize + haloSize + haloSize;
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        double const rX = 1.0 / (dx * dx);
+        double const rY = 1.0 / (dy * dy);
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // fill shared memory
+        for(auto i = blockThreadIdx[0]; i < smemSize2D[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < smemSize2D[1]; j += blockThreadExtent[1])
+            {
+                auto localIdx2D = alpaka::Vec(i, j);
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto globalIdx = localIdx2D + blockStartThreadIdx;
+                sdata[localIdx1D] = y1Buf(globalIdx[0], globalIdx[1]);
+            }
+        }
+
+        alpaka::syncBlockThreads(acc);
+
+        double threadSum = 0.0;
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                auto localIdx2D = alpaka::Vec(i, j) + haloSize;
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto const globalIdx = localIdx2D + blockStartThreadIdx;
+
+                double const y0 = y0Buf(globalIdx[0], globalIdx[1]);
+                double const y1 = sdata[localIdx1D];
+                double const f1 = T_Stencil::laplace(sdata, localIdx1D, smemSize2D[1], rX, rY);
+                double const f0 = f0Buf(globalIdx[0], globalIdx[1]);
+                double const estimate = (12.0 * (y0 - y1) + 6.0 * dt * (f0 + f1)) / 15.0;
+                double const yMax = alpaka::math::max(acc, alpaka::math::abs(acc, y0), alpaka::math::abs(acc, y1));
+                double const weight = absTolerance + relTolerance * yMax;
+                threadSum += (estimate / weight) * (estimate / weight);
+            }
+        }
+        atomicAddBlockSum<T_BlockSize1D>(acc, result, threadSum);
+    }
+};
@@ -0,0 +1,127 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+//! Layout of a row-major tile with halo in shared memory
+//!
+//! Every row of the tile is padded to a row pitch that is a multiple of the alignment, and the tile starts at an
+//! offset such that the first core column of every row is aligned. Padding the rows moves the columns of consecutive
+//! rows into different banks on GPUs. The shared memory array is an array of Groups of alignment elements, so the
+//! aligned core columns are Groups that fill stores at once, which the CPU back-ends can emit as aligned SIMD stores.
+//! Each thread of fill loads the alignment consecutive elements of a Group, on GPUs the default alignment of one
+//! keeps the loads of neighbouring threads coalesced. The element (i, j) of the tile, j counted from the left halo
+//! column, is at offset + i * rowPitch + j.
+//!
+//! The kernels declare the shared memory array with the alignment of a Group:
+//!     auto& sgroups = alpaka::declareSharedVar<typename TLayout::Group[TLayout::numGroups(size)], __COUNTER__>(acc);
+//!     double* const sdata = sgroups[0].values;
+//!
+//! \tparam T_RowPadding number of elements added to every row before rounding up to the alignment
+//! \tparam T_Alignment alignment of the first core column of every row in elements, a power of two, also the number
+//!                     of elements of a Group
+template<uint32_t T_RowPadding = 0u, uint32_t T_Alignment = 1u>
+struct SharedTileLayout
+{
+    static_assert(
+        T_Alignment > 0u && (T_Alignment & (T_Alignment - 1u)) == 0u,
+        "The alignment is counted in elements and has to be a power of two");
+
+    static constexpr uint32_t rowPadding = T_RowPadding;
+    static constexpr uint32_t alignment = T_Alignment;
+
+    //! alignment consecutive elements of the tile at an aligned address
+    struct alignas(alignment * sizeof(double)) Group
+    {
+        double values[alignment];
+    };
+
+    //! Number of Groups of a shared memory array of at least size elements
+    ALPAKA_FN_HOST_ACC static constexpr auto numGroups(std::size_t const size) -> std::size_t
+    {
+        return (size + alignment - 1u) / alignment;
+    }
+
+    //! Number of elements of a tile row including the padding
+    //!
+    //! \param width number of columns of the tile including the halo
+    template<typename TIdx>
+    ALPAKA_FN_HOST_ACC static constexpr auto rowPitch(TIdx const width) -> TIdx
+    {
+        return (width + rowPadding + alignment - 1u) / alignment * alignment;
+    }
+
+    //! Index of the element (0, 0) of the tile, it aligns the first core column
+    //!
+    //! \param haloX number of halo columns on each side
+    template<typename TIdx>
+    ALPAKA_FN_HOST_ACC static constexpr auto offset(TIdx const haloX) -> TIdx
+    {
+        return (alignment - haloX % alignment) % alignment;
+    }
+
+    //! Number of elements of the tile, the size of the shared memory array
+    //!
+    //! \param height number of rows of the tile including the halo
+    //! \param width number of columns of the tile including the halo
+    //! \param haloX number of halo columns on each side
+    template<typename TIdx>
+    ALPAKA_FN_HOST_ACC static constexpr auto size(TIdx const height, TIdx const width, TIdx const haloX) -> TIdx
+    {
+        return offset(haloX) + height * rowPitch(width);
+    }
+
+    //! Fills the tile with all threads of the block
+    //!
+    //! The core columns of every row are filled in Groups, a thread loads the alignment consecutive elements of a
+    //! Group and stores them at once. The halo columns and the core columns that do not fill a Group are loaded one by
+    //! one in a second pass. Both passes distribute their work over all threads of the block.
+    //!
+    //! \param sgroups shared memory array of at least numGroups(size(tileSize2D[0], tileSize2D[1], haloX)) Groups
+    //! \param tileSize2D rows and columns of the tile including the halo
+    //! \param haloX number of halo columns on each side
+    //! \param threadIdx1D index of the thread in the block
+    //! \param numThreads number of threads of the block
+    //! \param load returns the value of the element (i, j) of the tile from global memory
+    template<typename TIdx, typename TLoad>
+    ALPAKA_FN_ACC static auto fill(
+        Group* const sgroups,
+        alpaka::Vec<alpaka::DimInt<2u>, TIdx> const& tileSize2D,
+        TIdx const haloX,
+        TIdx const threadIdx1D,
+        TIdx const numThreads,
+        TLoad const& load) -> void
+    {
+        TIdx const pitch = rowPitch(tileSize2D[1]);
+        TIdx const tileOffset = offset(haloX);
+
+        // the first core column of a row is aligned, so the Groups of the core columns are elements of sgroups
+        TIdx const numCoreGroups = (tileSize2D[1] - 2 * haloX) / alignment;
+        for(TIdx idx = threadIdx1D; idx < tileSize2D[0] * numCoreGroups; idx += numThreads)
+        {
+            TIdx const i = idx / numCoreGroups;
+            TIdx const j = haloX + (idx % numCoreGroups) * alignment;
+            Group group;
+            for(uint32_t k = 0; k < alignment; ++k)
+                group.values[k] = load(i, j + k);
+            sgroups[(tileOffset + i * pitch + j) / alignment] = group;
+        }
+
+        // the left halo columns, then the remaining core columns and the right halo columns
+        double* const tile = sgroups[0].values + tileOffset;
+        TIdx const numSingles = tileSize2D[1] - numCoreGroups * alignment;
+        for(TIdx idx = threadIdx1D; idx < tileSize2D[0] * numSingles; idx += numThreads)
+        {
+            TIdx const i = idx / numSingles;
+            TIdx const single = idx % numSingles;
+            TIdx const j = single < haloX ? single : single + numCoreGroups * alignment;
+            tile[i * pitch + j] = load(i, j);
+        }
+    }
+};
@@ -0,0 +1,126 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstdint>
+
+//! Symmetric cross-shaped finite-difference stencil of the Laplacian u_xx + u_yy
+//!
+//! A stencil descriptor derives from this class and provides
+//!   - radius: number of neighbours on each side in x and y, which is also the required halo size
+//!   - weight(distance): coefficient of the second derivative along one axis for the neighbours at the given distance
+//!                       from the center, in units of 1 / h^2
+//!
+//! \tparam TStencil stencil descriptor
+template<typename TStencil>
+struct CrossStencil
+{
+    //! Gershgorin bound of the spectral radius of the second derivative along one axis in units of 1 / h^2
+    static constexpr auto spectralRadius() -> double
+    {
+        double sum = 0.0;
+        for(uint32_t distance = 0; distance <= TStencil::radius; ++distance)
+        {
+            double const weight = TStencil::weight(distance);
+            sum += (distance == 0 ? 1.0 : 2.0) * (weight < 0.0 ? -weight : weight);
+        }
+        return sum;
+    }
+
+    //! Floating point operations of laplace per cell, the coefficient of the center is loop-invariant
+    static constexpr auto flopsPerCell() -> double
+    {
+        // two sums of the pairs, their factors, their sum, the weight and the accumulation per distance
+        return 1.0 + 7.0 * TStencil::radius;
+    }
+
+    //! Laplacian of a cell of a row-major shared memory tile
+    //!
+    //! \param sdata tile holding the cell and at least radius neighbours on each side
+    //! \param localIdx1D index of the cell in the tile
+    //! \param rowPitch number of elements of a tile row
+    //! \param rX 1 / dx^2, or any other factor of the second derivative in x
+    //! \param rY 1 / dy^2, or any other factor of the second derivative in y
+    template<typename TData, typename TIdx>
+    ALPAKA_FN_ACC static auto laplace(
+        TData const& sdata,
+        TIdx const localIdx1D,
+        TIdx const rowPitch,
+        double const rX,
+        double const rY) -> double
+    {
+        double result = TStencil::weight(0) * (rX + rY) * sdata[localIdx1D];
+        for(TIdx distance = 1; distance <= TStencil::radius; ++distance)
+        {
+            result += TStencil::weight(distance)
+                      * ((sdata[localIdx1D - distance] + sdata[localIdx1D + distance]) * rX
+                         + (sdata[localIdx1D - distance * rowPitch] + sdata[localIdx1D + distance * rowPitch]) * rY);
+        }
+        return result;
+    }
+
+    //! Laplacian of a cell of a 2D mdspan, the same sum as laplace
+    //!
+    //! \param u mdspan of {Y, X} cells holding the cell and at least radius neighbours on each side
+    //! \param i index of the cell in y
+    //! \param j index of the cell in x
+    //! \param rX 1 / dx^2, or any other factor of the second derivative in x
+    //! \param rY 1 / dy^2, or any other factor of the second derivative in y
+    template<typename TMdSpan, typename TIdx>
+    ALPAKA_FN_ACC static auto laplaceAt(
+        TMdSpan const& u,
+        TIdx const i,
+        TIdx const j,
+        double const rX,
+        double const rY) -> double
+    {
+        double result = TStencil::weight(0) * (rX + rY) * u(i, j);
+        for(TIdx distance = 1; distance <= TStencil::radius; ++distance)
+        {
+            result += TStencil::weight(distance)
+                      * ((u(i, j - distance) + u(i, j + distance)) * rX
+                         + (u(i - distance, j) + u(i + distance, j)) * rY);
+        }
+        return result;
+    }
+};
+
+//! Second order stencil with five points
+struct FivePointStencil : CrossStencil<FivePointStencil>
+{
+    static constexpr uint32_t radius = 1;
+
+    ALPAKA_FN_HOST_ACC static constexpr auto weight(uint32_t const distance) -> double
+    {
+        constexpr double weights[] = {-2.0, 1.0};
+        return weights[distance];
+    }
+};
+
+//! Fourth order stencil with nine points
+struct NinePointStencil : CrossStencil<NinePointStencil>
+{
+    static constexpr uint32_t radius = 2;
+
+    ALPAKA_FN_HOST_ACC static constexpr auto weight(uint32_t const distance) -> double
+    {
+        constexpr double weights[] = {-5.0 / 2.0, 4.0 / 3.0, -1.0 / 12.0};
+        return weights[distance];
+    }
+};
+
+//! Sixth order stencil with thirteen points
+struct ThirteenPointStencil : CrossStencil<ThirteenPointStencil>
+{
+    static constexpr uint32_t radius = 3;
+
+    ALPAKA_FN_HOST_ACC static constexpr auto weight(uint32_t const distance) -> double
+    {
+        constexpr double weights[] = {-49.0 / 18.0, 3.0 / 2.0, -3.0 / 20.0, 1.0 / 90.0};
+        return weights[distance];
+    }
+};
@@ -4,14 +4,20 @@
 
 #pragma once
 
+#include "LinearAlgebraKernels.hpp"
+#include "SharedTileLayout.hpp"
+#include "Stencil.hpp"
+
 #include <alpaka/alpaka.hpp>
 
 //! alpaka version of explicit finite-difference 2D heat equation solver
 //!
-//! \tparam T_SharedMemSize1D size of the shared memory box
+//! \tparam T_SharedMemSize1D size of the shared memory box, at least T_TileLayout::size of the tile
+//! \tparam T_Stencil finite-difference stencil of the Laplacian, see Stencil.hpp
+//! \tparam T_TileLayout padding and alignment of the shared memory tile, see SharedTileLayout.hpp
 //!
 //! Solving equation u_t(x, t) = u_xx(x, t) + u_yy(y, t) using a simple explicit scheme with
-//! forward difference in t and second-order central difference in x and y
+//! forward difference in t and central differences of the order of the stencil in x and y
 //!
 //! \param uCurrBuf Current buffer with grid values of u for each x, y pair and the current value of t:
 //!                 u(x, y, t) | t = t_current
@@ -23,9 +29,24 @@
 //! \param dx step in x
 //! \param dy step in y
 //! \param dt step in t
-template<size_t T_SharedMemSize1D>
+//!
+//! The monitored overload takes a trailing maxChange and additionally reduces max |uNext - uCurr| over the core cells
+//! in the same pass. The tile is reused as the buffer of the block reduction, the block maximum is added atomically:
+//! \param maxChange pointer to a single value in device memory, has to be zeroed before the launch
+//!
+//! The ensemble overload takes buffers of {E, Y, X} cells holding E independent simulations, one per block index in
+//! the batch dimension:
+//! \param diffusivity diffusivity of each member of the ensemble, u_t = diffusivity * (u_xx + u_yy)
+//! \param chunkSize {1, Y, X}
+//! \param haloSize {0, Y, X}
+template<size_t T_SharedMemSize1D, typename T_Stencil = FivePointStencil, typename T_TileLayout = SharedTileLayout<>>
 struct StencilKernel
 {
+    //! compulsory traffic per core cell for the roofline, the cell is read once and its next value written once
+    static constexpr double bytesPerCell = 2.0 * sizeof(double);
+    //! the Laplacian and the addition of the current value
+    static constexpr double flopsPerCell = T_Stencil::flopsPerCell() + 1.0;
+
     template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
     ALPAKA_FN_ACC auto operator()(
         TAcc const& acc,
@@ -37,7 +58,10 @@ struct StencilKernel
         double const dy,
         double const dt) const -> void
     {
-        auto& sdata = alpaka::declareSharedVar<double[T_SharedMemSize1D], __COUNTER__>(acc);
+        auto& sgroups = alpaka::declareSharedVar<
+            typename T_TileLayout::Group[T_TileLayout::numGroups(T_SharedMemSize1D)],
+            __COUNTER__>(acc);
+        double* const sdata = sgroups[0].values;
         auto smemSize2D = chunkSize + haloSize + haloSize;
 
         // Get indexes
@@ -52,33 +76,164 @@ struct StencilKernel
         auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
 
         // fill shared memory
-        for(auto i = blockThreadIdx[0]; i < smemSize2D[0]; i += blockThreadExtent[0])
+        auto const rowPitch = T_TileLayout::rowPitch(smemSize2D[1]);
+        double const* const tile = sdata + T_TileLayout::offset(haloSize[1]);
+        T_TileLayout::fill(
+            sgroups,
+            smemSize2D,
+            haloSize[1],
+            alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u],
+            blockThreadExtent.prod(),
+            [&](TIdx const i, TIdx const j)
+            { return uCurrBuf(blockStartThreadIdx[0] + i, blockStartThreadIdx[1] + j); });
+
+        alpaka::syncBlockThreads(acc);
+
+        // go over only core cells and update nextBuf
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
         {
-            for(auto j = blockThreadIdx[1]; j < smemSize2D[1]; j += blockThreadExtent[1])
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
             {
-                auto localIdx2D = alpaka::Vec(i, j);
-                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
-                auto globalIdx = localIdx2D + blockStartThreadIdx;
-                sdata[localIdx1D] = uCurrBuf(globalIdx[0], globalIdx[1]);
+                // offset for halo, as we only want to go over core cells
+                auto localIdx2D = alpaka::Vec(i, j) + haloSize;
+                auto localIdx1D = localIdx2D[0] * rowPitch + localIdx2D[1];
+                auto const globalIdx = localIdx2D + blockStartThreadIdx;
+
+                uNextBuf(globalIdx[0], globalIdx[1])
+                    = tile[localIdx1D] + T_Stencil::laplace(tile, localIdx1D, rowPitch, rX, rY);
             }
         }
+    }
+
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uCurrBuf,
+        TMdSpan uNextBuf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt,
+        double* const maxChange) const -> void
+    {
+        auto& sgroups = alpaka::declareSharedVar<
+            typename T_TileLayout::Group[T_TileLayout::numGroups(T_SharedMemSize1D)],
+            __COUNTER__>(acc);
+        double* const sdata = sgroups[0].values;
+        auto smemSize2D = chunkSize + haloSize + haloSize;
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        double const rX = dt / (dx * dx);
+        double const rY = dt / (dy * dy);
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // fill shared memory
+        auto const rowPitch = T_TileLayout::rowPitch(smemSize2D[1]);
+        double const* const tile = sdata + T_TileLayout::offset(haloSize[1]);
+        T_TileLayout::fill(
+            sgroups,
+            smemSize2D,
+            haloSize[1],
+            alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u],
+            blockThreadExtent.prod(),
+            [&](TIdx const i, TIdx const j)
+            { return uCurrBuf(blockStartThreadIdx[0] + i, blockStartThreadIdx[1] + j); });
 
         alpaka::syncBlockThreads(acc);
 
-        // go over only core cells and update nextBuf
+        // go over only core cells and update nextBuf, the change stays in a register
+        double threadMaxChange = 0.0;
         for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
         {
             for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
             {
                 // offset for halo, as we only want to go over core cells
                 auto localIdx2D = alpaka::Vec(i, j) + haloSize;
-                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto localIdx1D = localIdx2D[0] * rowPitch + localIdx2D[1];
                 auto const globalIdx = localIdx2D + blockStartThreadIdx;
 
-                uNextBuf(globalIdx[0], globalIdx[1]) = sdata[localIdx1D] * (1.0 - 2.0 * rX - 2.0 * rY)
-                                                       + sdata[localIdx1D - 1] * rX + sdata[localIdx1D + 1] * rX
-                                                       + sdata[localIdx1D - smemSize2D[1]] * rY
-                                                       + sdata[localIdx1D + smemSize2D[1]] * rY;
+                double const change = T_Stencil::laplace(tile, localIdx1D, rowPitch, rX, rY);
+                uNextBuf(globalIdx[0], globalIdx[1]) = tile[localIdx1D] + change;
+                threadMaxChange = alpaka::math::max(acc, threadMaxChange, alpaka::math::abs(acc, change));
+            }
+        }
+
+        // all threads are done with the tile, it holds at least one value per thread of the block
+        alpaka::syncBlockThreads(acc);
+        double const blockMaxChange = blockReduce(
+            acc,
+            sdata,
+            threadMaxChange,
+            [&acc](double const a, double const b) { return alpaka::math::max(acc, a, b); });
+        if(alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u] == 0)
+        {
+            alpaka::atomicMax(acc, maxChange, blockMaxChange);
+        }
+    }
+
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uCurrBuf,
+        TMdSpan uNextBuf,
+        double const* const diffusivity,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt) const -> void
+    {
+        auto& sgroups = alpaka::declareSharedVar<
+            typename T_TileLayout::Group[T_TileLayout::numGroups(T_SharedMemSize1D)],
+            __COUNTER__>(acc);
+        double* const sdata = sgroups[0].values;
+        // the tile of a member is 2D in {Y, X}
+        auto const smemSize2D = alpaka::Vec<alpaka::DimInt<2u>, TIdx>{
+            chunkSize[1] + 2 * haloSize[1],
+            chunkSize[2] + 2 * haloSize[2]};
+
+        // Get indexes, the batch dimension of the block index selects the member
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+        auto const member = gridBlockIdx[0];
+
+        double const rX = diffusivity[member] * dt / (dx * dx);
+        double const rY = diffusivity[member] * dt / (dy * dy);
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // fill shared memory
+        auto const rowPitch = T_TileLayout::rowPitch(smemSize2D[1]);
+        double const* const tile = sdata + T_TileLayout::offset(haloSize[2]);
+        T_TileLayout::fill(
+            sgroups,
+            smemSize2D,
+            haloSize[2],
+            alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u],
+            blockThreadExtent.prod(),
+            [&](TIdx const i, TIdx const j)
+            { return uCurrBuf(member, blockStartThreadIdx[1] + i, blockStartThreadIdx[2] + j); });
+
+        alpaka::syncBlockThreads(acc);
+
+        // go over only core cells and update nextBuf
+        for(auto i = blockThreadIdx[1]; i < chunkSize[1]; i += blockThreadExtent[1])
+        {
+            for(auto j = blockThreadIdx[2]; j < chunkSize[2]; j += blockThreadExtent[2])
+            {
+                // offset for halo, as we only want to go over core cells
+                auto localIdx2D = alpaka::Vec(i + haloSize[1], j + haloSize[2]);
+                auto localIdx1D = localIdx2D[0] * rowPitch + localIdx2D[1];
+
+                uNextBuf(member, blockStartThreadIdx[1] + localIdx2D[0], blockStartThreadIdx[2] + localIdx2D[1])
+                    = tile[localIdx1D] + T_Stencil::laplace(tile, localIdx1D, rowPitch, rX, rY);
             }
         }
     }
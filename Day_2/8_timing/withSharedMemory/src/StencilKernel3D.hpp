@@ -0,0 +1,129 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "Stencil.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+//! alpaka version of explicit finite-difference 3D heat equation solver with 2.5D streaming
+//!
+//! \tparam T_SharedMemSize1D size of the shared memory box, (2 * radius + 1) planes of the xy tile including the halo
+//! \tparam T_Stencil finite-difference stencil of the Laplacian, applied along x, y and z. The five-point stencil
+//!                   gives the seven-point stencil in 3D.
+//!
+//! Solving equation u_t(x, y, z, t) = u_xx + u_yy + u_zz using a simple explicit scheme with forward difference in t
+//! and central differences of the order of the stencil in x, y and z
+//!
+//! Every block owns a {Z, Y, X} chunk and streams through it along z, the slowest dimension. The xy planes of the
+//! chunk, including the halo, pass through a queue of 2 * radius + 1 planes in shared memory, so every value is read
+//! from global memory once per time step. The queue is kept in shared memory instead of registers, so a thread can
+//! handle several cells of a plane, as on the CPU accelerators with a single thread per block.
+//!
+//! \param uCurrBuf Current buffer with grid values of u for each x, y, z and the current value of t:
+//!                 u(x, y, z, t) | t = t_current
+//! \param uNextBuf resulting grid values of u for each x, y, z and the next value of t:
+//!              u(x, y, z, t) | t = t_current + dt
+//! \param chunkSize The size of the chunk in {Z, Y, X} handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Z, Y, X} (below, above and to the left)
+//! \param dx step in x
+//! \param dy step in y
+//! \param dz step in z
+//! \param dt step in t
+template<size_t T_SharedMemSize1D, typename T_Stencil = FivePointStencil>
+struct StencilKernel3D
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uCurrBuf,
+        TMdSpan uNextBuf,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dz,
+        double const dt) const -> void
+    {
+        constexpr TIdx radius = T_Stencil::radius;
+        constexpr TIdx numPlanes = 2 * radius + 1;
+
+        auto& sdata = alpaka::declareSharedVar<double[T_SharedMemSize1D], __COUNTER__>(acc);
+        // extent of one plane in {Y, X}
+        auto const planeSize2D = alpaka::Vec<alpaka::DimInt<2u>, TIdx>{
+            chunkSize[1] + 2 * haloSize[1],
+            chunkSize[2] + 2 * haloSize[2]};
+        auto const planeSize1D = planeSize2D.prod();
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = gridBlockIdx * chunkSize;
+
+        double const rX = dt / (dx * dx);
+        double const rY = dt / (dy * dy);
+        double const rZ = dt / (dz * dz);
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // copies the plane z of the chunk (z = 0 is the first plane of the lower halo) into its slot of the queue
+        auto loadPlane = [&](TIdx const z)
+        {
+            double* const plane = sdata + (z % numPlanes) * planeSize1D;
+            for(auto i = blockThreadIdx[1]; i < planeSize2D[0]; i += blockThreadExtent[1])
+            {
+                for(auto j = blockThreadIdx[2]; j < planeSize2D[1]; j += blockThreadExtent[2])
+                {
+                    auto const localIdx1D = alpaka::mapIdx<1>(alpaka::Vec(i, j), planeSize2D)[0u];
+                    plane[localIdx1D] = uCurrBuf(
+                        blockStartThreadIdx[0] + z,
+                        blockStartThreadIdx[1] + i,
+                        blockStartThreadIdx[2] + j);
+                }
+            }
+        };
+
+        // the lower halo and all planes but the last one of the upper halo of the first core plane
+        for(TIdx z = 0; z < numPlanes - 1; ++z)
+            loadPlane(z);
+
+        for(TIdx k = 0; k < chunkSize[0]; ++k)
+        {
+            // the core plane k has the index k + radius in the queue, its last upper neighbour is added now
+            loadPlane(k + numPlanes - 1);
+
+            alpaka::syncBlockThreads(acc);
+
+            double const* const center = sdata + ((k + radius) % numPlanes) * planeSize1D;
+            for(auto i = blockThreadIdx[1]; i < chunkSize[1]; i += blockThreadExtent[1])
+            {
+                for(auto j = blockThreadIdx[2]; j < chunkSize[2]; j += blockThreadExtent[2])
+                {
+                    auto const localIdx2D = alpaka::Vec(i, j) + alpaka::Vec(haloSize[1], haloSize[2]);
+                    auto const localIdx1D = alpaka::mapIdx<1>(localIdx2D, planeSize2D)[0u];
+
+                    // second derivative in z from the planes below and above
+                    double laplaceZ = T_Stencil::weight(0) * center[localIdx1D];
+                    for(TIdx distance = 1; distance <= radius; ++distance)
+                    {
+                        double const below = sdata[((k + radius - distance) % numPlanes) * planeSize1D + localIdx1D];
+                        double const above = sdata[((k + radius + distance) % numPlanes) * planeSize1D + localIdx1D];
+                        laplaceZ += T_Stencil::weight(distance) * (below + above);
+                    }
+
+                    uNextBuf(
+                        blockStartThreadIdx[0] + haloSize[0] + k,
+                        blockStartThreadIdx[1] + localIdx2D[0],
+                        blockStartThreadIdx[2] + localIdx2D[1])
+                        = center[localIdx1D] + T_Stencil::laplace(center, localIdx1D, planeSize2D[1], rX, rY)
+                          + laplaceZ * rZ;
+                }
+            }
+
+            // the oldest plane of the queue is overwritten in the next iteration
+            alpaka::syncBlockThreads(acc);
+        }
+    }
+};
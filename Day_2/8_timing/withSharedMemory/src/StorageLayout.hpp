@@ -0,0 +1,308 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+//! Shift of the grid so that the cell origin starts a tile
+//!
+//! \param tileSize extent of the tile in one dimension
+//! \param origin first cell of a tile in the same dimension, e.g. the size of the halo so that the core of every
+//!               chunk is a tile
+template<typename TIdx>
+constexpr auto tileShift(TIdx const tileSize, TIdx const origin) -> TIdx
+{
+    return (tileSize - origin % tileSize) % tileSize;
+}
+
+//! mdspan layout of a 2D grid stored as contiguous tiles
+//!
+//! The tiles are row-major within the grid and the cells are row-major within a tile. With the chunk size as the tile
+//! size and the halo size as the origin, the core of every chunk is one contiguous burst of memory and the halo cells
+//! at the border of the grid get tiles of their own.
+struct LayoutTiled
+{
+    template<typename TExtents>
+    class mapping
+    {
+        static_assert(TExtents::rank() == 2, "The tiled layout is only defined for 2D grids");
+
+    public:
+        using extents_type = TExtents;
+        using index_type = typename TExtents::index_type;
+        using size_type = typename TExtents::size_type;
+        using rank_type = typename TExtents::rank_type;
+        using layout_type = LayoutTiled;
+
+        constexpr mapping() = default;
+
+        //! \param extents extents of the grid in {Y, X}
+        //! \param tileSize extent of a tile in {Y, X}
+        //! \param origin cell in {Y, X} that starts a tile
+        constexpr mapping(
+            extents_type const& extents,
+            std::array<index_type, 2> const& tileSize,
+            std::array<index_type, 2> const& origin)
+            : m_extents{extents}
+            , m_tileSize{tileSize}
+            , m_shift{tileShift(tileSize[0], origin[0]), tileShift(tileSize[1], origin[1])}
+            , m_numTilesX{(extents.extent(1) + m_shift[1] + tileSize[1] - 1) / tileSize[1]}
+            , m_numTilesY{(extents.extent(0) + m_shift[0] + tileSize[0] - 1) / tileSize[0]}
+        {
+        }
+
+        constexpr auto extents() const -> extents_type const&
+        {
+            return m_extents;
+        }
+
+        constexpr auto required_span_size() const -> index_type
+        {
+            return m_numTilesY * m_numTilesX * m_tileSize[0] * m_tileSize[1];
+        }
+
+        template<typename TIdxY, typename TIdxX>
+        constexpr auto operator()(TIdxY const i, TIdxX const j) const -> index_type
+        {
+            auto const y = static_cast<index_type>(i) + m_shift[0];
+            auto const x = static_cast<index_type>(j) + m_shift[1];
+            auto const tile = y / m_tileSize[0] * m_numTilesX + x / m_tileSize[1];
+            return (tile * m_tileSize[0] + y % m_tileSize[0]) * m_tileSize[1] + x % m_tileSize[1];
+        }
+
+        static constexpr auto is_always_unique() -> bool
+        {
+            return true;
+        }
+
+        static constexpr auto is_always_exhaustive() -> bool
+        {
+            return false;
+        }
+
+        static constexpr auto is_always_strided() -> bool
+        {
+            return false;
+        }
+
+        static constexpr auto is_unique() -> bool
+        {
+            return true;
+        }
+
+        constexpr auto is_exhaustive() const -> bool
+        {
+            return required_span_size() == m_extents.extent(0) * m_extents.extent(1);
+        }
+
+        static constexpr auto is_strided() -> bool
+        {
+            return false;
+        }
+
+        friend constexpr auto operator==(mapping const& lhs, mapping const& rhs) -> bool
+        {
+            return lhs.m_extents == rhs.m_extents && lhs.m_tileSize == rhs.m_tileSize && lhs.m_shift == rhs.m_shift;
+        }
+
+    private:
+        extents_type m_extents{};
+        std::array<index_type, 2> m_tileSize{1, 1};
+        std::array<index_type, 2> m_shift{0, 0};
+        index_type m_numTilesX = 0;
+        index_type m_numTilesY = 0;
+    };
+};
+
+//! mdspan layout of a 2D grid in Morton (Z-) order
+//!
+//! The index of a cell interleaves the bits of its y and x index, so every aligned square of a power of two side is
+//! contiguous. The grid is shifted like the tiled layout, with a tile size of a power of two the core of every chunk
+//! is one of these squares. The grid is stored in the enclosing square of a power of two side.
+struct LayoutMorton
+{
+    template<typename TExtents>
+    class mapping
+    {
+        static_assert(TExtents::rank() == 2, "The Morton layout is only defined for 2D grids");
+
+    public:
+        using extents_type = TExtents;
+        using index_type = typename TExtents::index_type;
+        using size_type = typename TExtents::size_type;
+        using rank_type = typename TExtents::rank_type;
+        using layout_type = LayoutMorton;
+
+        constexpr mapping() = default;
+
+        //! \param extents extents of the grid in {Y, X}
+        //! \param tileSize extent in {Y, X} of the aligned squares, powers of two
+        //! \param origin cell in {Y, X} that starts an aligned square
+        constexpr mapping(
+            extents_type const& extents,
+            std::array<index_type, 2> const& tileSize,
+            std::array<index_type, 2> const& origin)
+            : m_extents{extents}
+            , m_shift{tileShift(tileSize[0], origin[0]), tileShift(tileSize[1], origin[1])}
+        {
+            auto const largestExtent = std::max(extents.extent(0) + m_shift[0], extents.extent(1) + m_shift[1]);
+            while(m_side < largestExtent)
+                m_side *= 2;
+        }
+
+        constexpr auto extents() const -> extents_type const&
+        {
+            return m_extents;
+        }
+
+        constexpr auto required_span_size() const -> index_type
+        {
+            return m_side * m_side;
+        }
+
+        template<typename TIdxY, typename TIdxX>
+        constexpr auto operator()(TIdxY const i, TIdxX const j) const -> index_type
+        {
+            auto const y = static_cast<std::uint64_t>(i) + m_shift[0];
+            auto const x = static_cast<std::uint64_t>(j) + m_shift[1];
+            return static_cast<index_type>(spreadBits(y) << 1 | spreadBits(x));
+        }
+
+        static constexpr auto is_always_unique() -> bool
+        {
+            return true;
+        }
+
+        static constexpr auto is_always_exhaustive() -> bool
+        {
+            return false;
+        }
+
+        static constexpr auto is_always_strided() -> bool
+        {
+            return false;
+        }
+
+        static constexpr auto is_unique() -> bool
+        {
+            return true;
+        }
+
+        constexpr auto is_exhaustive() const -> bool
+        {
+            return required_span_size() == m_extents.extent(0) * m_extents.extent(1);
+        }
+
+        static constexpr auto is_strided() -> bool
+        {
+            return false;
+        }
+
+        friend constexpr auto operator==(mapping const& lhs, mapping const& rhs) -> bool
+        {
+            return lhs.m_extents == rhs.m_extents && lhs.m_shift == rhs.m_shift;
+        }
+
+    private:
+        //! Moves bit b of the lower 32 bits of value to bit 2 * b
+        static constexpr auto spreadBits(std::uint64_t value) -> std::uint64_t
+        {
+            value &= 0xffff'ffffu;
+            value = (value | value << 16) & 0x0000'ffff'0000'ffffu;
+            value = (value | value << 8) & 0x00ff'00ff'00ff'00ffu;
+            value = (value | value << 4) & 0x0f0f'0f0f'0f0f'0f0fu;
+            value = (value | value << 2) & 0x3333'3333'3333'3333u;
+            value = (value | value << 1) & 0x5555'5555'5555'5555u;
+            return value;
+        }
+
+        extents_type m_extents{};
+        std::array<index_type, 2> m_shift{0, 0};
+        index_type m_side = 1;
+    };
+};
+
+//! 2D grid buffer with a custom mdspan layout
+//!
+//! \tparam TDev device the memory is allocated on
+//! \tparam TElem type of the elements
+//! \tparam TIdx index type
+//! \tparam TLayout mdspan layout of the grid, LayoutTiled or LayoutMorton
+//!
+//! The memory is a 1D alpaka buffer of the span of the layout. The kernels access the grid through the mdspan of
+//! getGridMdSpan, the grid is only reordered into a row-major buffer when it is copied to the host, see
+//! copyGridToHost.
+template<typename TDev, typename TElem, typename TIdx, typename TLayout>
+class LayoutBuffer
+{
+public:
+    using Vec = alpaka::Vec<alpaka::DimInt<2u>, TIdx>;
+    using Extents = std::experimental::dextents<TIdx, 2>;
+    using Mapping = typename TLayout::template mapping<Extents>;
+    using MdSpan = std::experimental::mdspan<TElem, Extents, TLayout>;
+
+    //! \param dev device the memory is allocated on
+    //! \param extent extent of the grid in {Y, X} including the halo
+    //! \param tileSize extent of a tile in {Y, X}, the chunk size of the kernels
+    //! \param origin cell in {Y, X} that starts a tile, the halo size of the kernels
+    LayoutBuffer(TDev const& dev, Vec const& extent, Vec const& tileSize, Vec const& origin)
+        : m_mapping{Extents{extent[0], extent[1]}, {tileSize[0], tileSize[1]}, {origin[0], origin[1]}}
+        , m_storage{alpaka::allocBuf<TElem, TIdx>(dev, static_cast<TIdx>(m_mapping.required_span_size()))}
+    {
+    }
+
+    auto getMapping() const -> Mapping const&
+    {
+        return m_mapping;
+    }
+
+    auto getStorage() -> alpaka::Buf<TDev, TElem, alpaka::DimInt<1u>, TIdx>&
+    {
+        return m_storage;
+    }
+
+    auto getMdSpan() -> MdSpan
+    {
+        return MdSpan{alpaka::getPtrNative(m_storage), m_mapping};
+    }
+
+private:
+    Mapping m_mapping;
+    alpaka::Buf<TDev, TElem, alpaka::DimInt<1u>, TIdx> m_storage;
+};
+
+//! mdspan of the grid of a LayoutBuffer
+template<typename TDev, typename TElem, typename TIdx, typename TLayout>
+auto getGridMdSpan(LayoutBuffer<TDev, TElem, TIdx, TLayout>& buf)
+{
+    return buf.getMdSpan();
+}
+
+//! Copies the grid of a LayoutBuffer into the row-major host buffer hostBuf
+//!
+//! The memory is copied as it is and reordered on the host, the queue is waited for.
+template<typename TQueue, typename THostBuf, typename TDev, typename TElem, typename TIdx, typename TLayout>
+auto copyGridToHost(TQueue& queue, THostBuf& hostBuf, LayoutBuffer<TDev, TElem, TIdx, TLayout>& buf) -> void
+{
+    using Buffer = LayoutBuffer<TDev, TElem, TIdx, TLayout>;
+    auto storageHost = alpaka::allocBuf<TElem, TIdx>(
+        alpaka::getDev(hostBuf),
+        static_cast<TIdx>(buf.getMapping().required_span_size()));
+    alpaka::memcpy(queue, storageHost, buf.getStorage());
+    alpaka::wait(queue);
+
+    typename Buffer::MdSpan const grid{alpaka::getPtrNative(storageHost), buf.getMapping()};
+    auto rowMajor = alpaka::experimental::getMdSpan(hostBuf);
+    for(TIdx i = 0; i < grid.extent(0); ++i)
+    {
+        for(TIdx j = 0; j < grid.extent(1); ++j)
+            rowMajor(i, j) = grid(i, j);
+    }
+}
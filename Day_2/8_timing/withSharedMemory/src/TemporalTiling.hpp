@@ -0,0 +1,109 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "Stencil.hpp"
+#include "TemporalTilingKernel.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+//! Explicit time stepping with split temporal tiling for the CPU accelerators
+//!
+//! The plain step loop streams the whole grid through the caches every step. Here the steps are grouped into bands
+//! and every block advances a tile through all steps of a band, see TemporalTilingKernel. Tiles of a few chunks stay
+//! in the cache of the thread that runs the block, so the grid only passes through memory once per band. The tiles
+//! are scheduled without redundant computation. The updates are the same as in the plain stepping, only the boundary
+//! values are evaluated from the analytical solution in the kernel.
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+template<typename TAcc, typename T_Stencil = FivePointStencil>
+class TemporalTiling
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using Vec = alpaka::Vec<Dim, Idx>;
+
+    //! \param extent extent of the grid in {Y, X} including the halo
+    //! \param haloSize size of the halo in {Y, X}
+    //! \param tileSize width of the tiles in {Y, X}, it has to divide the core of the grid
+    //! \param threadsPerBlock threads of a block, they share the cells of a tile
+    //! \param dx step in x
+    //! \param dy step in y
+    //! \param dt step in t
+    TemporalTiling(
+        Vec const& extent,
+        Vec const& haloSize,
+        Vec const& tileSize,
+        Vec const& threadsPerBlock,
+        double const dx,
+        double const dy,
+        double const dt)
+        : m_haloSize(haloSize)
+        , m_tileSize(tileSize)
+        , m_dx(dx)
+        , m_dy(dy)
+        , m_dt(dt)
+        , m_workDiv{
+              Vec{(extent[0] - 2 * haloSize[0]) / tileSize[0], (extent[1] - 2 * haloSize[1]) / tileSize[1]},
+              threadsPerBlock,
+              Vec::ones()}
+    {
+        assert(
+            (extent[0] - 2 * haloSize[0]) % tileSize[0] == 0 && (extent[1] - 2 * haloSize[1]) % tileSize[1] == 0
+            && "The core of the grid must be divisible by the tile size");
+    }
+
+    //! Largest number of steps of a band, the tiles have to hold the dependency cone of the band
+    auto maxStepsPerBand() const -> uint32_t
+    {
+        return std::min(m_tileSize[0], m_tileSize[1]) / (2 * T_Stencil::radius);
+    }
+
+    //! Advance the values in uCurr by numSteps time steps
+    //!
+    //! The levels alternate between the buffers, the result is in uCurrBuf for an even number of steps and in
+    //! uNextBuf for an odd one, as if the buffers were swapped after every step.
+    //!
+    //! \param firstStep number of the first time step of the band, it sets the time of the boundary values
+    //! \param numSteps number of time steps, at most maxStepsPerBand
+    template<typename TQueue, typename TMdSpan>
+    auto advance(TQueue& queue, TMdSpan uCurrBuf, TMdSpan uNextBuf, uint32_t const firstStep, uint32_t const numSteps)
+        -> void
+    {
+        assert(numSteps <= maxStepsPerBand() && "The band does not fit into the tiles");
+        // the shrinking tiles first, the growing tiles need the values of their neighbours
+        for(auto const& growing : {Vec{0, 0}, Vec{0, 1}, Vec{1, 0}, Vec{1, 1}})
+        {
+            alpaka::exec<TAcc>(
+                queue,
+                m_workDiv,
+                TemporalTilingKernel<T_Stencil>{},
+                uCurrBuf,
+                uNextBuf,
+                m_tileSize,
+                m_haloSize,
+                growing,
+                firstStep,
+                numSteps,
+                m_dx,
+                m_dy,
+                m_dt);
+        }
+    }
+
+private:
+    Vec m_haloSize;
+    Vec m_tileSize;
+    double m_dx;
+    double m_dy;
+    double m_dt;
+    alpaka::WorkDivMembers<Dim, Idx> m_workDiv;
+};
@@ -0,0 +1,111 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "Stencil.hpp"
+#include "analyticalSolution.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstdint>
+
+//! Advances one tile of a split temporal tiling through all time steps of a band
+//!
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+//!
+//! The boundaries b_0 = 0 < b_1 < ... < b_n = extent split every dimension into n tiles. A shrinking tile starts as
+//! [b_k, b_k+1) and loses radius cells on each inner side per step, a growing tile starts empty at the inner boundary
+//! b_k and gains radius cells on each side per step, so at every step the tiles cover the grid. A shrinking tile only
+//! depends on itself, a growing tile also on the shrinking tiles next to it. The 2D tiles combine the shrinking and
+//! growing tiles of y and x. Launched in the order {0, 0}, {0, 1}, {1, 0}, {1, 1}, the tiles of a launch are
+//! independent and the diamonds of the band are complete after the last launch.
+//!
+//! The even time levels of the band are in uEvenBuf and the odd ones in uOddBuf. A value of level l - 1 is overwritten
+//! by level l + 1, which depends on all cells that read the value, so the order of the tiles respects the dependency
+//! cone. The halo cells of the grid get the boundary values of their time level.
+//!
+//! \param uEvenBuf values at the beginning of the band, receives the even time levels
+//! \param uOddBuf receives the odd time levels
+//! \param tileSize width of the tiles in {Y, X}, at least 2 * numSteps * radius
+//! \param haloSize Size of halo required for our stencil in {Y, X}, the first and the last tile include the halo
+//! \param growing {Y, X}, 0 for the shrinking and 1 for the growing tiles of the dimension
+//! \param firstStep number of the first time step of the band
+//! \param numSteps number of time steps of the band
+//! \param dx step in x
+//! \param dy step in y
+//! \param dt step in t
+template<typename T_Stencil>
+struct TemporalTilingKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uEvenBuf,
+        TMdSpan uOddBuf,
+        alpaka::Vec<TDim, TIdx> const& tileSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        alpaka::Vec<TDim, TIdx> const& growing,
+        uint32_t const firstStep,
+        uint32_t const numSteps,
+        double const dx,
+        double const dy,
+        double const dt) const -> void
+    {
+        constexpr TIdx radius = T_Stencil::radius;
+
+        // Get indexes
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const gridBlockExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+        alpaka::Vec<TDim, TIdx> const extent{
+            static_cast<TIdx>(uEvenBuf.extent(0)),
+            static_cast<TIdx>(uEvenBuf.extent(1))};
+
+        double const rX = dt / (dx * dx);
+        double const rY = dt / (dy * dy);
+
+        // boundary k of the tiling in dimension d, there is one tile per block
+        auto const boundary = [&](unsigned const d, TIdx const k) -> TIdx
+        { return k == 0 ? 0 : (k == gridBlockExtent[d] ? extent[d] : haloSize[d] + k * tileSize[d]); };
+        // first cell and past the last cell of the tile of the block in dimension d at step s of the band
+        auto const first = [&](unsigned const d, TIdx const s) -> TIdx
+        {
+            auto const k = gridBlockIdx[d];
+            if(growing[d] != 0)
+                return k + 1 < gridBlockExtent[d] ? boundary(d, k + 1) - s * radius : 0;
+            return k == 0 ? 0 : boundary(d, k) + s * radius;
+        };
+        auto const last = [&](unsigned const d, TIdx const s) -> TIdx
+        {
+            auto const k = gridBlockIdx[d];
+            if(growing[d] != 0)
+                return k + 1 < gridBlockExtent[d] ? boundary(d, k + 1) + s * radius : 0;
+            return k + 1 == gridBlockExtent[d] ? extent[d] : boundary(d, k + 1) - s * radius;
+        };
+
+        for(TIdx s = 1; s <= numSteps; ++s)
+        {
+            auto const& uPrev = s % 2 == 1 ? uEvenBuf : uOddBuf;
+            auto const& uNext = s % 2 == 1 ? uOddBuf : uEvenBuf;
+            uint32_t const step = firstStep + s - 1;
+
+            for(auto i = first(0, s) + blockThreadIdx[0]; i < last(0, s); i += blockThreadExtent[0])
+            {
+                for(auto j = first(1, s) + blockThreadIdx[1]; j < last(1, s); j += blockThreadExtent[1])
+                {
+                    if(i < haloSize[0] || i >= extent[0] - haloSize[0] || j < haloSize[1]
+                       || j >= extent[1] - haloSize[1])
+                        uNext(i, j) = analyticalSolution(acc, j * dx, i * dy, step * dt);
+                    else
+                        uNext(i, j) = uPrev(i, j) + T_Stencil::laplaceAt(uPrev, i, j, rX, rY);
+                }
+            }
+
+            // the next step reads the values of the neighbouring threads
+            alpaka::syncBlockThreads(acc);
+        }
+    }
+};
@@ -0,0 +1,154 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "TileActivityKernels.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstdint>
+#include <utility>
+
+//! Explicit time stepping that skips the tiles of quiescent regions
+//!
+//! Every tile carries a changed flag in device memory. Each step the TileActivityKernel compacts the tiles whose own
+//! values or halo may have changed into a list, and the SparseStencilKernel updates only the listed tiles and sets
+//! their flags again. Problems with localized activity then cost in proportion to the active region. The whole step
+//! stays on the device, no count is copied to the host.
+//!
+//! \tparam TAcc accelerator type
+//! \tparam T_SharedMemSize1D size of the shared memory box of the SparseStencilKernel
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+template<typename TAcc, size_t T_SharedMemSize1D, typename T_Stencil = FivePointStencil>
+class TileActivity
+{
+public:
+    using Dim = alpaka::Dim<TAcc>;
+    using Idx = alpaka::Idx<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using BufAcc = alpaka::Buf<DevAcc, double, Dim, Idx>;
+    using WorkDiv = alpaka::WorkDivMembers<Dim, Idx>;
+
+    //! \param devAcc device the activity buffers are allocated on
+    //! \param workDivCore work division with one block per chunk
+    //! \param numChunks number of chunks in {Y, X}
+    //! \param chunkSize size of the chunk handled by one block
+    //! \param haloSize size of the halo in {Y, X}
+    //! \param dx step in x
+    //! \param dy step in y
+    //! \param dt step in t
+    //! \param epsilon largest change of a cell that still counts as unchanged
+    TileActivity(
+        DevAcc const& devAcc,
+        WorkDiv const& workDivCore,
+        alpaka::Vec<Dim, Idx> const& numChunks,
+        alpaka::Vec<Dim, Idx> const& chunkSize,
+        alpaka::Vec<Dim, Idx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt,
+        double const epsilon = 1e-12)
+        : m_changedPrev(alpaka::allocBuf<uint32_t, Idx>(devAcc, numChunks.prod()))
+        , m_changedNext(alpaka::allocBuf<uint32_t, Idx>(devAcc, numChunks.prod()))
+        , m_activeTiles(alpaka::allocBuf<Idx, Idx>(devAcc, numChunks.prod()))
+        , m_numActiveTiles(alpaka::allocBuf<Idx, Idx>(devAcc, Idx{1}))
+        , m_numTileUpdatesAcc(alpaka::allocBuf<Idx, Idx>(devAcc, Idx{1}))
+        , m_numTileUpdatesHost(alpaka::allocBuf<Idx, Idx>(alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0), Idx{1}))
+        , m_numChunks(numChunks)
+        , m_chunkSize(chunkSize)
+        , m_haloSize(haloSize)
+        , m_dx(dx)
+        , m_dy(dy)
+        , m_dt(dt)
+        , m_epsilon(epsilon)
+        , m_workDivCore(workDivCore)
+        , m_workDivTiles(makeWorkDivTiles(devAcc))
+    {
+        // all tiles are active in the first step
+        alpaka::Queue<TAcc, alpaka::Blocking> queue{devAcc};
+        alpaka::memset(queue, m_changedPrev, 1u);
+        alpaka::memset(queue, m_numTileUpdatesAcc, 0u);
+    }
+
+    //! Advance uCurr by one time step into uNext on the core cells of the active tiles
+    template<typename TQueue>
+    auto step(TQueue& queue, BufAcc& uCurrBuf, BufAcc& uNextBuf) -> void
+    {
+        alpaka::memset(queue, m_numActiveTiles, 0u);
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivTiles,
+            m_tileActivityKernel,
+            alpaka::getPtrNative(m_changedPrev),
+            alpaka::getPtrNative(m_changedNext),
+            alpaka::getPtrNative(m_activeTiles),
+            alpaka::getPtrNative(m_numActiveTiles),
+            alpaka::getPtrNative(m_numTileUpdatesAcc),
+            m_numChunks);
+        alpaka::exec<TAcc>(
+            queue,
+            m_workDivCore,
+            m_sparseStencilKernel,
+            alpaka::experimental::getMdSpan(uCurrBuf),
+            alpaka::experimental::getMdSpan(uNextBuf),
+            alpaka::getPtrNative(m_activeTiles),
+            alpaka::getPtrNative(m_numActiveTiles),
+            alpaka::getPtrNative(m_changedNext),
+            m_numChunks,
+            m_chunkSize,
+            m_haloSize,
+            m_dx,
+            m_dy,
+            m_dt,
+            m_epsilon);
+        std::swap(m_changedPrev, m_changedNext);
+    }
+
+    //! Number of tile updates over all steps so far, blocks until the queue is finished
+    template<typename TQueue>
+    auto numTileUpdates(TQueue& queue) -> Idx
+    {
+        alpaka::memcpy(queue, m_numTileUpdatesHost, m_numTileUpdatesAcc);
+        alpaka::wait(queue);
+        return *alpaka::getPtrNative(m_numTileUpdatesHost);
+    }
+
+private:
+    //! One thread per tile
+    auto makeWorkDivTiles(DevAcc const& devAcc) -> WorkDiv
+    {
+        alpaka::KernelCfg<TAcc> const cfgTiles = {m_numChunks, alpaka::Vec<Dim, Idx>::ones()};
+        return alpaka::getValidWorkDiv(
+            cfgTiles,
+            devAcc,
+            m_tileActivityKernel,
+            alpaka::getPtrNative(m_changedPrev),
+            alpaka::getPtrNative(m_changedNext),
+            alpaka::getPtrNative(m_activeTiles),
+            alpaka::getPtrNative(m_numActiveTiles),
+            alpaka::getPtrNative(m_numTileUpdatesAcc),
+            m_numChunks);
+    }
+
+    TileActivityKernel m_tileActivityKernel;
+    SparseStencilKernel<T_SharedMemSize1D, T_Stencil> m_sparseStencilKernel;
+
+    alpaka::Buf<DevAcc, uint32_t, alpaka::DimInt<1u>, Idx> m_changedPrev;
+    alpaka::Buf<DevAcc, uint32_t, alpaka::DimInt<1u>, Idx> m_changedNext;
+    alpaka::Buf<DevAcc, Idx, alpaka::DimInt<1u>, Idx> m_activeTiles;
+    alpaka::Buf<DevAcc, Idx, alpaka::DimInt<1u>, Idx> m_numActiveTiles;
+    alpaka::Buf<DevAcc, Idx, alpaka::DimInt<1u>, Idx> m_numTileUpdatesAcc;
+    alpaka::Buf<alpaka::DevCpu, Idx, alpaka::DimInt<1u>, Idx> m_numTileUpdatesHost;
+
+    alpaka::Vec<Dim, Idx> m_numChunks;
+    alpaka::Vec<Dim, Idx> m_chunkSize;
+    alpaka::Vec<Dim, Idx> m_haloSize;
+    double m_dx;
+    double m_dy;
+    double m_dt;
+    double m_epsilon;
+    WorkDiv m_workDivCore;
+    WorkDiv m_workDivTiles;
+};
@@ -0,0 +1,171 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "LinearAlgebraKernels.hpp"
+#include "Stencil.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <cstdint>
+
+//! Builds the compact list of the tiles that have to be updated in this step
+//!
+//! A tile is active if it or one of its eight neighbours changed in the previous step, as the neighbours provide its
+//! halo. Tiles at the edge of the domain are always active, their halo holds the time dependent boundary values. The
+//! kernel runs one thread per tile.
+//!
+//! \param changedPrev flag per tile, whether it changed in the previous step
+//! \param changedNext flag per tile for the current step, reset to zero for the stencil kernel to set it
+//! \param activeTiles list of the 1D indices of the active tiles
+//! \param numActiveTiles pointer to a single value in device memory, has to be zeroed before the launch
+//! \param numTileUpdates pointer to a single value in device memory, counts the updated tiles over all steps
+//! \param numChunks number of tiles in {Y, X}
+struct TileActivityKernel
+{
+    template<typename TAcc, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        uint32_t const* const changedPrev,
+        uint32_t* const changedNext,
+        TIdx* const activeTiles,
+        TIdx* const numActiveTiles,
+        TIdx* const numTileUpdates,
+        alpaka::Vec<TDim, TIdx> const& numChunks) const -> void
+    {
+        auto const tileIdx = alpaka::getIdx<alpaka::Grid, alpaka::Threads>(acc);
+        if(tileIdx[0] >= numChunks[0] || tileIdx[1] >= numChunks[1])
+            return;
+        auto const tileIdx1D = alpaka::mapIdx<1>(tileIdx, numChunks)[0u];
+
+        bool active = tileIdx[0] == 0 || tileIdx[0] == numChunks[0] - 1 || tileIdx[1] == 0
+                      || tileIdx[1] == numChunks[1] - 1;
+        for(TIdx i = tileIdx[0] - (tileIdx[0] > 0 ? 1 : 0); !active && i <= tileIdx[0] + 1 && i < numChunks[0]; ++i)
+        {
+            for(TIdx j = tileIdx[1] - (tileIdx[1] > 0 ? 1 : 0); j <= tileIdx[1] + 1 && j < numChunks[1]; ++j)
+            {
+                active = active || changedPrev[i * numChunks[1] + j] != 0;
+            }
+        }
+
+        changedNext[tileIdx1D] = 0;
+        if(active)
+        {
+            activeTiles[alpaka::atomicAdd(acc, numActiveTiles, TIdx{1})] = tileIdx1D;
+            alpaka::atomicAdd(acc, numTileUpdates, TIdx{1});
+        }
+    }
+};
+
+//! Explicit stencil update of the active tiles only
+//!
+//! \tparam T_SharedMemSize1D size of the shared memory box
+//! \tparam T_Stencil finite-difference stencil of the Laplacian
+//!
+//! Same update as the StencilKernel, but block b handles the tile activeTiles[b]. The work division keeps one block
+//! per tile, so the number of active tiles never has to be copied to the host, and the blocks beyond numActiveTiles
+//! exit right away. The active tiles are packed into the first blocks. The inactive tiles are not written, they keep
+//! the values of two steps before, which differ by less than epsilon.
+//!
+//! Every active tile reduces max |uNext - uCurr| like the monitored StencilKernel and flags itself as changed if it
+//! exceeds epsilon.
+//!
+//! \param uCurrBuf Current buffer with grid values of u for each x, y pair and the current value of t
+//! \param uNextBuf resulting grid values of u for each x, y pair and the next value of t
+//! \param activeTiles list of the 1D indices of the active tiles
+//! \param numActiveTiles pointer to the number of active tiles in device memory
+//! \param changed flag per tile, set if the tile changed by more than epsilon
+//! \param numChunks number of tiles in {Y, X}
+//! \param chunkSize The size of the chunk or tile that the user divides the problem into. This defines the size of the
+//!                  workload handled by each thread block.
+//! \param haloSize Size of halo required for our stencil in {Y, X} (above and to the left)
+//! \param dx step in x
+//! \param dy step in y
+//! \param dt step in t
+//! \param epsilon largest change of a cell that still counts as unchanged
+template<size_t T_SharedMemSize1D, typename T_Stencil = FivePointStencil>
+struct SparseStencilKernel
+{
+    template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
+    ALPAKA_FN_ACC auto operator()(
+        TAcc const& acc,
+        TMdSpan uCurrBuf,
+        TMdSpan uNextBuf,
+        TIdx const* const activeTiles,
+        TIdx const* const numActiveTiles,
+        uint32_t* const changed,
+        alpaka::Vec<TDim, TIdx> const& numChunks,
+        alpaka::Vec<TDim, TIdx> const& chunkSize,
+        alpaka::Vec<TDim, TIdx> const& haloSize,
+        double const dx,
+        double const dy,
+        double const dt,
+        double const epsilon) const -> void
+    {
+        auto const gridBlockIdx = alpaka::getIdx<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const gridBlockExtent = alpaka::getWorkDiv<alpaka::Grid, alpaka::Blocks>(acc);
+        auto const gridBlockIdx1D = alpaka::mapIdx<1>(gridBlockIdx, gridBlockExtent)[0u];
+        // the whole block leaves, so no thread misses a synchronization
+        if(gridBlockIdx1D >= *numActiveTiles)
+            return;
+        auto const tileIdx1D = activeTiles[gridBlockIdx1D];
+        auto const tileIdx = alpaka::Vec<TDim, TIdx>{tileIdx1D / numChunks[1], tileIdx1D % numChunks[1]};
+
+        auto& sdata = alpaka::declareSharedVar<double[T_SharedMemSize1D], __COUNTER__>(acc);
+        auto smemSize2D = chunkSize + haloSize + haloSize;
+
+        // Get indexes
+        auto const blockThreadIdx = alpaka::getIdx<alpaka::Block, alpaka::Threads>(acc);
+        auto const blockStartThreadIdx = tileIdx * chunkSize;
+
+        double const rX = dt / (dx * dx);
+        double const rY = dt / (dy * dy);
+
+        auto const blockThreadExtent = alpaka::getWorkDiv<alpaka::Block, alpaka::Threads>(acc);
+
+        // fill shared memory
+        for(auto i = blockThreadIdx[0]; i < smemSize2D[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < smemSize2D[1]; j += blockThreadExtent[1])
+            {
+                auto localIdx2D = alpaka::Vec(i, j);
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto globalIdx = localIdx2D + blockStartThreadIdx;
+                sdata[localIdx1D] = uCurrBuf(globalIdx[0], globalIdx[1]);
+            }
+        }
+
+        alpaka::syncBlockThreads(acc);
+
+        // go over only core cells and update nextBuf
+        double threadMaxChange = 0.0;
+        for(auto i = blockThreadIdx[0]; i < chunkSize[0]; i += blockThreadExtent[0])
+        {
+            for(auto j = blockThreadIdx[1]; j < chunkSize[1]; j += blockThreadExtent[1])
+            {
+                // offset for halo, as we only want to go over core cells
+                auto localIdx2D = alpaka::Vec(i, j) + haloSize;
+                auto localIdx1D = alpaka::mapIdx<1>(localIdx2D, smemSize2D)[0u];
+                auto const globalIdx = localIdx2D + blockStartThreadIdx;
+
+                double const change = T_Stencil::laplace(sdata, localIdx1D, smemSize2D[1], rX, rY);
+                uNextBuf(globalIdx[0], globalIdx[1]) = sdata[localIdx1D] + change;
+                threadMaxChange = alpaka::math::max(acc, threadMaxChange, alpaka::math::abs(acc, change));
+            }
+        }
+
+        // all threads are done with the tile, it holds at least one value per thread of the block
+        alpaka::syncBlockThreads(acc);
+        double const blockMaxChange = blockReduce(
+            acc,
+            sdata,
+            threadMaxChange,
+            [&acc](double const a, double const b) { return alpaka::math::max(acc, a, b); });
+        if(alpaka::mapIdx<1>(blockThreadIdx, blockThreadExtent)[0u] == 0)
+        {
+            changed[tileIdx1D] = blockMaxChange > epsilon ? 1u : 0u;
+        }
+    }
+};
@@ -0,0 +1,250 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//! Timeline of the host threads and the queues of an example
+//!
+//! With ENABLE_TRACING every traced activity is recorded as a begin and end timestamp, either on the track of the host
+//! thread (TraceScope) or on the track of a queue (QueueTracer). The events are written as Chrome trace-event JSON
+//! when the program exits, to the file in HEAT_EQUATION_TRACE or trace.json. chrome://tracing or ui.perfetto.dev
+//! show the timeline, e.g. whether the copies of the dump queue overlap the steps of the compute queue. Without
+//! ENABLE_TRACING all of it compiles to nothing.
+#ifdef ENABLE_TRACING
+constexpr bool enableTracing = true;
+#else
+constexpr bool enableTracing = false;
+#endif
+
+//! Activity between beginNs and endNs on a track of the timeline
+struct TraceEvent
+{
+    //! name of the activity, a string literal
+    char const* name;
+    //! name of the queue, a string literal, or nullptr for the host thread threadId
+    char const* track;
+    uint32_t threadId;
+    uint64_t beginNs;
+    uint64_t endNs;
+};
+
+//! Lock-free ring buffer of the trace events of all threads
+//!
+//! A writer claims a slot with a single atomic increment, there are no locks on the recording path. Once the buffer is
+//! full the oldest events are overwritten. The buffer is written to the trace file when it is destroyed at exit.
+class TraceBuffer
+{
+public:
+    static constexpr std::size_t capacity = std::size_t{1} << 16;
+
+    static auto instance() -> TraceBuffer&
+    {
+        static TraceBuffer buffer;
+        return buffer;
+    }
+
+    //! Nanoseconds since the first timestamp of the program
+    static auto now() -> uint64_t
+    {
+        static auto const start = std::chrono::steady_clock::now();
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    //! \param name name of the activity, a string literal
+    //! \param track name of the queue, a string literal, or nullptr for the calling host thread
+    auto record(char const* const name, char const* const track, uint64_t const beginNs, uint64_t const endNs) -> void
+    {
+        auto const slot = m_numEvents.fetch_add(1u, std::memory_order_relaxed) % capacity;
+        m_events[slot] = TraceEvent{name, track, threadId(), beginNs, endNs};
+    }
+
+    ~TraceBuffer()
+    {
+        char const* const path = std::getenv("HEAT_EQUATION_TRACE");
+        write(path != nullptr ? path : "trace.json");
+    }
+
+    TraceBuffer(TraceBuffer const&) = delete;
+    auto operator=(TraceBuffer const&) -> TraceBuffer& = delete;
+
+private:
+    TraceBuffer() : m_events(capacity)
+    {
+    }
+
+    //! Small index of the calling host thread, in the order of their first event
+    static auto threadId() -> uint32_t
+    {
+        static std::atomic<uint32_t> numThreads{0u};
+        thread_local uint32_t const id = numThreads.fetch_add(1u, std::memory_order_relaxed);
+        return id;
+    }
+
+    //! Writes the events as complete events ("ph": "X"), every queue gets a track of its own after the host threads
+    auto write(std::string const& path) const -> void
+    {
+        auto const numEvents = m_numEvents.load(std::memory_order_acquire);
+        auto const numStored = numEvents < capacity ? numEvents : capacity;
+        std::vector<char const*> queueTracks;
+        uint32_t numThreads = 0u;
+        auto const trackId = [&](TraceEvent const& event) -> uint32_t
+        {
+            if(event.track == nullptr)
+                return event.threadId;
+            for(std::size_t i = 0; i < queueTracks.size(); ++i)
+            {
+                if(std::strcmp(queueTracks[i], event.track) == 0)
+                    return queueTracksBegin + static_cast<uint32_t>(i);
+            }
+            queueTracks.push_back(event.track);
+            return queueTracksBegin + static_cast<uint32_t>(queueTracks.size() - 1u);
+        };
+
+        std::ofstream file{path};
+        file << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+        for(std::size_t i = 0; i < numStored; ++i)
+        {
+            auto const& event = m_events[i];
+            if(event.track == nullptr && event.threadId + 1u > numThreads)
+                numThreads = event.threadId + 1u;
+            file << (i == 0 ? "\n" : ",\n") << "{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": 0, "
+                 << "\"tid\": " << trackId(event) << ", \"ts\": " << event.beginNs / 1e3
+                 << ", \"dur\": " << (event.endNs - event.beginNs) / 1e3 << "}";
+        }
+        for(uint32_t thread = 0u; thread < numThreads; ++thread)
+            writeTrackName(file, thread, "host thread " + std::to_string(thread));
+        for(std::size_t i = 0; i < queueTracks.size(); ++i)
+            writeTrackName(file, queueTracksBegin + static_cast<uint32_t>(i), queueTracks[i]);
+        file << "\n]}\n";
+
+        std::cout << "Trace of " << numStored << " events written to " << path;
+        if(numEvents > capacity)
+            std::cout << ", the first " << numEvents - capacity << " events were overwritten";
+        std::cout << std::endl;
+    }
+
+    static auto writeTrackName(std::ofstream& file, uint32_t const id, std::string const& name) -> void
+    {
+        file << ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << id
+             << ", \"args\": {\"name\": \"" << name << "\"}}";
+    }
+
+    //! track id of the first queue, the host threads come first
+    static constexpr uint32_t queueTracksBegin = 1000u;
+
+    std::vector<TraceEvent> m_events;
+    std::atomic<std::size_t> m_numEvents{0u};
+};
+
+//! Records the lifetime of the scope on the track of the host thread
+class TraceScope
+{
+public:
+    //! \param name name of the activity, a string literal
+    explicit TraceScope(char const* const name) : m_name{name}
+    {
+        if constexpr(enableTracing)
+            m_beginNs = TraceBuffer::now();
+    }
+
+    ~TraceScope()
+    {
+        if constexpr(enableTracing)
+            TraceBuffer::instance().record(m_name, nullptr, m_beginNs, TraceBuffer::now());
+    }
+
+    TraceScope(TraceScope const&) = delete;
+    auto operator=(TraceScope const&) -> TraceScope& = delete;
+
+private:
+    char const* m_name;
+    uint64_t m_beginNs = 0u;
+};
+
+//! Waits for the queue and records the wait on the track of the host thread
+//!
+//! \param name name of the activity, a string literal
+template<typename TQueue>
+auto traceWait(TQueue& queue, char const* const name) -> void
+{
+    TraceScope const scope{name};
+    alpaka::wait(queue);
+}
+
+//! Records the work enqueued between begin and end on the track of a queue
+//!
+//! On CPU devices begin and end enqueue host tasks that take the timestamps when the queue reaches them, so the event
+//! shows when the work runs. Other devices cannot run host tasks in their queues, there the event only covers the
+//! submission of the work on the host thread. The spans of a queue must not nest.
+//!
+//! \tparam TQueue alpaka queue
+template<typename TQueue>
+class QueueTracer
+{
+public:
+    //! \param queue traced queue, it has to outlive the tracer
+    //! \param track name of the queue in the timeline, a string literal
+    QueueTracer(TQueue& queue, char const* const track) : m_queue{queue}, m_track{track}
+    {
+        if constexpr(enableTracing)
+            m_beginNs = std::make_shared<uint64_t>(0u);
+    }
+
+    //! \param name name of the activity, a string literal
+    auto begin(char const* const name) -> void
+    {
+        if constexpr(enableTracing)
+        {
+            m_name = name;
+            if constexpr(timestampsInQueue)
+            {
+                auto task = [beginNs = m_beginNs]() noexcept { *beginNs = TraceBuffer::now(); };
+                alpaka::enqueue(m_queue, task);
+            }
+            else
+                *m_beginNs = TraceBuffer::now();
+        }
+    }
+
+    auto end() -> void
+    {
+        if constexpr(enableTracing)
+        {
+            if constexpr(timestampsInQueue)
+            {
+                auto task = [beginNs = m_beginNs, name = m_name, track = m_track]() noexcept
+                { TraceBuffer::instance().record(name, track, *beginNs, TraceBuffer::now()); };
+                alpaka::enqueue(m_queue, task);
+            }
+            else
+                TraceBuffer::instance().record(m_name, m_track, *m_beginNs, TraceBuffer::now());
+        }
+    }
+
+private:
+    //! whether the timestamps are taken by host tasks in the queue
+    static constexpr bool timestampsInQueue = std::is_same_v<alpaka::Dev<TQueue>, alpaka::DevCpu>;
+
+    TQueue& m_queue;
+    char const* m_track;
+    char const* m_name = nullptr;
+    std::shared_ptr<uint64_t> m_beginNs;
+};
@@ -8,6 +8,10 @@
 
 #include <cmath>
 
+//! Floating point operations of the 2D analyticalSolution for the roofline, the exponential and the sines count as
+//! one operation each. The kernels add the scaling of their indices.
+constexpr double analyticalSolutionFlops = 8.0;
+
 //! Exact solution to the test problem at postion (x,y) at time t
 //! u_t(x, y, t) = u_xx(x, t) + u_yy(y, t), x in [0, 1], y in [0, 1], t in [0, T]
 //!
@@ -27,6 +31,46 @@ auto analyticalSolution(double const x, double const y, double const t) -> doubl
     return std::exp(-pi * pi * t) * (std::sin(pi * x) + std::sin(pi * y));
 }
 
+//! The test problem is separable, u(x, y, t) = analyticalTimeFactor(t) * (analyticalProfile(x) + analyticalProfile(y))
+//!
+//! \param x value of x or y
+auto analyticalProfile(double const x) -> double
+{
+    constexpr double pi = alpaka::math::constants::pi;
+    return std::sin(pi * x);
+}
+
+//! Time dependent factor of the separable test problem, see analyticalProfile
+//!
+//! \param t value of t
+auto analyticalTimeFactor(double const t) -> double
+{
+    constexpr double pi = alpaka::math::constants::pi;
+    return std::exp(-pi * pi * t);
+}
+
+//! Exact solution to the 3D test problem at postion (x,y,z) at time t
+//! u_t(x, y, z, t) = u_xx + u_yy + u_zz, x in [0, 1], y in [0, 1], z in [0, 1], t in [0, T]
+//!
+//! \param x value of x
+//! \param y value of y
+//! \param z value of z
+//! \param t value of t
+template<typename TAcc>
+ALPAKA_FN_ACC auto analyticalSolution(TAcc const& acc, double const x, double const y, double const z, double const t)
+    -> double
+{
+    constexpr double pi = alpaka::math::constants::pi;
+    return alpaka::math::exp(acc, -pi * pi * t)
+           * (alpaka::math::sin(acc, pi * x) + alpaka::math::sin(acc, pi * y) + alpaka::math::sin(acc, pi * z));
+}
+
+auto analyticalSolution(double const x, double const y, double const z, double const t) -> double
+{
+    constexpr double pi = alpaka::math::constants::pi;
+    return std::exp(-pi * pi * t) * (std::sin(pi * x) + std::sin(pi * y) + std::sin(pi * z));
+}
+
 //! Valdidate calculated solution in the buffer to the analytical solution at t=tMax
 //!
 //! \param buffer buffer holding the solution at t
@@ -38,13 +82,59 @@ auto validateSolution(T_Buffer const& buffer, double const dx, double const dy,
     -> std::pair<bool, double>
 {
     auto extents = alpaka::getExtents(buffer);
+    // the rows may be padded
+    double const* const data = alpaka::getPtrNative(buffer);
+    auto const rowPitch = alpaka::getPitchesInBytes(buffer)[0] / sizeof(double);
     // Calculate error
     double maxError = 0.0;
     for(uint32_t j = 1; j < extents[0] - 1; ++j)
     {
         for(uint32_t i = 1; i < extents[1] - 1; ++i)
         {
-            auto const error = std::abs(buffer.data()[j * extents[1] + i] - analyticalSolution(i * dx, j * dy, t));
+            auto const error = std::abs(data[j * rowPitch + i] - analyticalSolution(i * dx, j * dy, t));
+            maxError = std::max(maxError, error);
+        }
+    }
+
+    constexpr double errorThreshold = 1e-4;
+    return std::make_pair(maxError < errorThreshold, maxError);
+}
+
+//! Cost of validateSolution per core cell for the roofline, the value is read and compared to the analytical solution
+struct ValidationCost
+{
+    static constexpr double bytesPerCell = sizeof(double);
+    //! the scaling of the indices, the difference, its absolute value and the maximum
+    static constexpr double flopsPerCell = analyticalSolutionFlops + 5.0;
+};
+
+//! Valdidate one member of an ensemble of {E, Y, X} cells to the analytical solution at t=tMax
+//!
+//! \param buffer buffer holding the solutions of all members at t
+//! \param member index of the member in the batch dimension
+//! \param dx
+//! \param dy
+//! \param t time of the member, the diffusivity of the member times the simulated time
+template<typename T_Buffer>
+auto validateEnsembleMember(
+    T_Buffer const& buffer,
+    uint32_t const member,
+    double const dx,
+    double const dy,
+    double const t) -> std::pair<bool, double>
+{
+    auto extents = alpaka::getExtents(buffer);
+    // the rows and members may be padded
+    auto const pitches = alpaka::getPitchesInBytes(buffer);
+    double const* const memberData = alpaka::getPtrNative(buffer) + member * pitches[0] / sizeof(double);
+    auto const rowPitch = pitches[1] / sizeof(double);
+    // Calculate error
+    double maxError = 0.0;
+    for(uint32_t j = 1; j < extents[1] - 1; ++j)
+    {
+        for(uint32_t i = 1; i < extents[2] - 1; ++i)
+        {
+            auto const error = std::abs(memberData[j * rowPitch + i] - analyticalSolution(i * dx, j * dy, t));
             maxError = std::max(maxError, error);
         }
     }
@@ -52,3 +142,40 @@ auto validateSolution(T_Buffer const& buffer, double const dx, double const dy,
     constexpr double errorThreshold = 1e-4;
     return std::make_pair(maxError < errorThreshold, maxError);
 }
+
+//! Valdidate calculated 3D solution in the buffer to the analytical solution at t=tMax
+//!
+//! \param buffer buffer holding the solution at t
+//! \param dx
+//! \param dy
+//! \param dz
+//! \param t
+template<typename T_Buffer>
+auto validateSolution(T_Buffer const& buffer, double const dx, double const dy, double const dz, double const t)
+    -> std::pair<bool, double>
+{
+    auto extents = alpaka::getExtents(buffer);
+    // the rows and planes may be padded
+    double const* const data = alpaka::getPtrNative(buffer);
+    auto const pitches = alpaka::getPitchesInBytes(buffer);
+    auto const planePitch = pitches[0] / sizeof(double);
+    auto const rowPitch = pitches[1] / sizeof(double);
+    // Calculate error
+    double maxError = 0.0;
+    for(uint32_t k = 1; k < extents[0] - 1; ++k)
+    {
+        for(uint32_t j = 1; j < extents[1] - 1; ++j)
+        {
+            for(uint32_t i = 1; i < extents[2] - 1; ++i)
+            {
+                auto const error = std::abs(
+                    data[k * planePitch + j * rowPitch + i]
+                    - analyticalSolution(i * dx, j * dy, k * dz, t));
+                maxError = std::max(maxError, error);
+            }
+        }
+    }
+
+    constexpr double errorThreshold = 1e-4;
+    return std::make_pair(maxError < errorThreshold, maxError);
+}
@@ -0,0 +1,61 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+//! Largest value of the conductivity field, it enters the stability condition of the explicit scheme
+constexpr double maxConductivity = 1.0;
+
+//! Conductivity of the material at position (x, y)
+//!
+//! A disc of poorly conducting material in a plate with unit conductivity. The jump at the rim of the disc is
+//! resolved by the harmonic mean of the face conductivities in the ConductivityStencilKernel.
+//!
+//! \param x value of x
+//! \param y value of y
+ALPAKA_FN_HOST_ACC inline auto conductivity(double const x, double const y) -> double
+{
+    constexpr double radius = 0.25;
+    constexpr double inclusionConductivity = 0.1;
+    double const distanceSquared = (x - 0.5) * (x - 0.5) + (y - 0.5) * (y - 0.5);
+    return distanceSquared < radius * radius ? inclusionConductivity : 1.0;
+}
+
+//! Validate the calculated solution in the buffer with a heterogeneous conductivity
+//!
+//! There is no analytical solution for the heterogeneous material. By the maximum principle the solution stays within
+//! the range of the initial and boundary values, which is [0, 2] for the test problem.
+//!
+//! \param buffer buffer holding the solution
+//! \return whether all values are within the bounds and the largest distance of a value outside of them
+template<typename T_Buffer>
+auto validateMaximumPrinciple(T_Buffer const& buffer) -> std::pair<bool, double>
+{
+    constexpr double lowerBound = 0.0;
+    constexpr double upperBound = 2.0;
+    auto extents = alpaka::getExtents(buffer);
+    // the rows may be padded
+    double const* const data = alpaka::getPtrNative(buffer);
+    auto const rowPitch = alpaka::getPitchesInBytes(buffer)[0] / sizeof(double);
+    double maxViolation = 0.0;
+    for(uint32_t j = 0; j < extents[0]; ++j)
+    {
+        for(uint32_t i = 0; i < extents[1]; ++i)
+        {
+            auto const value = data[j * rowPitch + i];
+            if(!std::isfinite(value))
+                return std::make_pair(false, value);
+            maxViolation = std::max({maxViolation, lowerBound - value, value - upperBound});
+        }
+    }
+
+    constexpr double errorThreshold = 1e-12;
+    return std::make_pair(maxViolation < errorThreshold, maxViolation);
+}
@@ -3,22 +3,49 @@
  * SPDX-License-Identifier: ISC
  */
 
+#include "AcceleratorSelection.hpp"
+#include "AlternatingDirectionImplicit.hpp"
+#include "BandwidthProbe.hpp"
+#include "Benchmark.hpp"
+#include "BoundaryConditions.hpp"
 #include "BoundaryKernel.hpp"
+#include "ConductivityStencilKernel.hpp"
+#include "ConjugateGradient.hpp"
+#include "InPlaceUpdate.hpp"
 #include "InitializeBufferKernel.hpp"
+#include "InitializeConductivityKernel.hpp"
+#include "Multigrid.hpp"
+#include "NumaPlacement.hpp"
+#include "PaddedBuffer.hpp"
+#include "PerfCounters.hpp"
+#include "Roofline.hpp"
+#include "RungeKuttaChebyshev.hpp"
+#include "SharedTileLayout.hpp"
+#include "Stencil.hpp"
 #include "StencilKernel.hpp"
+#include "StorageLayout.hpp"
+#include "TemporalTiling.hpp"
+#include "TileActivity.hpp"
+#include "Trace.hpp"
 #include "analyticalSolution.hpp"
+#include "conductivity.hpp"
 
 #ifdef PNGWRITER_ENABLED
 #    include "writeImage.hpp"
 #endif
 
 #include <alpaka/alpaka.hpp>
-#include <alpaka/example/ExecuteForEachAccTag.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #ifdef ENABLE_TIMING
 constexpr bool enableTiming = true;
@@ -26,6 +53,183 @@ constexpr bool enableTiming = true;
 constexpr bool enableTiming = false;
 #endif
 
+#ifdef ENABLE_VARIABLE_CONDUCTIVITY
+constexpr bool variableConductivity = true;
+#else
+constexpr bool variableConductivity = false;
+#endif
+
+#ifdef ENABLE_STEADY_STATE_DETECTION
+constexpr bool steadyStateDetection = true;
+#else
+constexpr bool steadyStateDetection = false;
+#endif
+
+#ifdef ENABLE_TILE_SKIPPING
+constexpr bool tileSkipping = true;
+#else
+constexpr bool tileSkipping = false;
+#endif
+
+#ifdef ENABLE_NUMA_FIRST_TOUCH
+constexpr bool numaFirstTouch = true;
+#else
+constexpr bool numaFirstTouch = false;
+#endif
+
+#ifdef ENABLE_TEMPORAL_TILING
+constexpr bool temporalTiling = true;
+#else
+constexpr bool temporalTiling = false;
+#endif
+
+#ifdef ENABLE_IN_PLACE_UPDATE
+constexpr bool inPlaceUpdate = true;
+#else
+constexpr bool inPlaceUpdate = false;
+#endif
+
+#ifdef ENABLE_PERF_COUNTERS
+constexpr bool perfCounters = true;
+#else
+constexpr bool perfCounters = false;
+#endif
+
+#ifdef ENABLE_ROOFLINE
+constexpr bool roofline = true;
+#else
+constexpr bool roofline = false;
+#endif
+
+//! Time integration schemes of the simulation
+enum class TimeIntegrator
+{
+    //! forward Euler, limited by the stability condition
+    Explicit,
+    //! theta scheme (Crank-Nicolson or backward Euler) solved by matrix-free conjugate gradients
+    ImplicitCG,
+    //! theta scheme solved by geometric multigrid V-cycles
+    ImplicitMG,
+    //! theta scheme solved by conjugate gradients preconditioned with a multigrid V-cycle
+    ImplicitMGCG,
+    //! Peaceman-Rachford alternating direction implicit scheme with batched tridiagonal solves
+    Adi,
+    //! second order Runge-Kutta-Chebyshev scheme with error controlled step size
+    AdaptiveRkc
+};
+
+#if defined(TIME_INTEGRATOR_IMPLICIT_CG)
+constexpr TimeIntegrator timeIntegrator = TimeIntegrator::ImplicitCG;
+#elif defined(TIME_INTEGRATOR_IMPLICIT_MG)
+constexpr TimeIntegrator timeIntegrator = TimeIntegrator::ImplicitMG;
+#elif defined(TIME_INTEGRATOR_IMPLICIT_MGCG)
+constexpr TimeIntegrator timeIntegrator = TimeIntegrator::ImplicitMGCG;
+#elif defined(TIME_INTEGRATOR_ADI)
+constexpr TimeIntegrator timeIntegrator = TimeIntegrator::Adi;
+#elif defined(TIME_INTEGRATOR_ADAPTIVE_RKC)
+constexpr TimeIntegrator timeIntegrator = TimeIntegrator::AdaptiveRkc;
+#else
+constexpr TimeIntegrator timeIntegrator = TimeIntegrator::Explicit;
+#endif
+
+//! Finite-difference stencil of the Laplacian, higher orders reach the same accuracy on coarser grids
+#if defined(STENCIL_NINE_POINT)
+using Stencil = NinePointStencil;
+#elif defined(STENCIL_THIRTEEN_POINT)
+using Stencil = ThirteenPointStencil;
+#else
+using Stencil = FivePointStencil;
+#endif
+
+//! Padding and alignment of the shared memory tile of the StencilKernel
+#if defined(SHARED_TILE_ROW_PADDING) && defined(SHARED_TILE_ALIGNMENT)
+using TileLayout = SharedTileLayout<SHARED_TILE_ROW_PADDING, SHARED_TILE_ALIGNMENT>;
+#else
+using TileLayout = SharedTileLayout<>;
+#endif
+
+//! Alignment of the rows of the grid buffers in bytes, 0 keeps the dense alpaka buffers. With an alignment the rows
+//! are padded and the first core cell of every row is aligned, see PaddedBuffer.
+#if defined(GRID_ROW_ALIGNMENT)
+constexpr std::size_t gridRowAlignment = GRID_ROW_ALIGNMENT;
+#else
+constexpr std::size_t gridRowAlignment = 0;
+#endif
+
+//! mdspan layout of the grids on the accelerator, layout_stride are the row-major alpaka buffers. The tiled and the
+//! Morton layout store the core of every chunk contiguously, see StorageLayout.hpp.
+#if defined(STORAGE_LAYOUT_TILED)
+using StorageLayout = LayoutTiled;
+#elif defined(STORAGE_LAYOUT_MORTON)
+using StorageLayout = LayoutMorton;
+#else
+using StorageLayout = std::experimental::layout_stride;
+#endif
+constexpr bool rowMajorStorage = std::is_same_v<StorageLayout, std::experimental::layout_stride>;
+
+//! Provider of the boundary values, the test problem is separable. Use AnalyticalBoundary for boundary conditions
+//! that cannot be separated.
+template<typename TAcc>
+using Boundary = SeparableBoundary<TAcc>;
+
+//! Whether every step is a single launch of the StencilKernel from uCurr into a separate uNext. Only then the timed
+//! launches of the bandwidth share and the roofline are the kernel of the simulation.
+constexpr bool plainStencilSteps = timeIntegrator == TimeIntegrator::Explicit && !variableConductivity && !tileSkipping
+                                   && !temporalTiling && !inPlaceUpdate;
+
+static_assert(
+    std::is_same_v<Stencil, FivePointStencil>
+        || (timeIntegrator != TimeIntegrator::ImplicitMG && timeIntegrator != TimeIntegrator::ImplicitMGCG
+            && timeIntegrator != TimeIntegrator::Adi),
+    "Multigrid and ADI only support the five-point stencil");
+
+static_assert(
+    !variableConductivity || (timeIntegrator == TimeIntegrator::Explicit && std::is_same_v<Stencil, FivePointStencil>),
+    "The variable conductivity is only supported by the explicit scheme with the five-point stencil");
+
+static_assert(
+    !steadyStateDetection || (timeIntegrator == TimeIntegrator::Explicit && !variableConductivity),
+    "The steady state detection is only supported by the explicit scheme with a uniform conductivity");
+
+static_assert(
+    !tileSkipping || (timeIntegrator == TimeIntegrator::Explicit && !variableConductivity && !steadyStateDetection),
+    "The tile skipping is only supported by the plain explicit scheme");
+
+static_assert(
+    gridRowAlignment == 0 || (timeIntegrator == TimeIntegrator::Explicit && !variableConductivity && !tileSkipping),
+    "The padded grid buffers are only supported by the explicit scheme with a uniform conductivity and without the "
+    "tile skipping");
+
+static_assert(
+    rowMajorStorage
+        || (timeIntegrator == TimeIntegrator::Explicit && !variableConductivity && !tileSkipping
+            && gridRowAlignment == 0 && !numaFirstTouch),
+    "The tiled and the Morton storage layout are only supported by the plain explicit scheme");
+
+static_assert(
+    !temporalTiling
+        || (timeIntegrator == TimeIntegrator::Explicit && !variableConductivity && !steadyStateDetection
+            && !tileSkipping),
+    "The temporal tiling is only supported by the plain explicit scheme");
+
+static_assert(
+    !inPlaceUpdate
+        || (timeIntegrator == TimeIntegrator::Explicit && !variableConductivity && !steadyStateDetection
+            && !tileSkipping && !temporalTiling),
+    "The in-place update is only supported by the plain explicit scheme");
+
+static_assert(
+    !perfCounters || (enableTiming && timeIntegrator == TimeIntegrator::Explicit),
+    "The hardware performance counters are only collected by the timing build of the explicit scheme");
+
+static_assert(
+    !roofline || (enableTiming && plainStencilSteps),
+    "The roofline is only reported by the timing build of the plain explicit scheme");
+
+static_assert(
+    !benchmark || (roofline && !steadyStateDetection),
+    "The benchmark compares the timings of the roofline over all time steps");
+
 //! Each kernel computes the next step for one point.
 //! Therefore the number of threads should be equal to numNodesX.
 //! Every time step the kernel will be executed numNodesX-times
@@ -58,35 +262,72 @@ auto example(TAccTag const&) -> int
 
     // simulation defines
     // {Y, X}
-    constexpr alpaka::Vec<Dim, Idx> numNodes{64, 64};
+    // The implicit scheme is meant for fine grids, where the explicit scheme needs tiny time steps. Higher order
+    // stencils need fewer nodes for the same accuracy.
+    constexpr Idx numNodesPerDim
+        = (timeIntegrator == TimeIntegrator::Explicit ? 64 : 128) / (Stencil::radius == 1 ? 1 : 2);
+    constexpr alpaka::Vec<Dim, Idx> numNodes{numNodesPerDim, numNodesPerDim};
     // Size of halo required for our stencil in {Y, X} (above and to the left).
-    constexpr alpaka::Vec<Dim, Idx> haloSize{1, 1};
+    constexpr alpaka::Vec<Dim, Idx> haloSize{Stencil::radius, Stencil::radius};
     // Halo size must be multiplied by two to get the extents, as their are halo cells below and to the right as well
     constexpr alpaka::Vec<Dim, Idx> extent = numNodes + haloSize + haloSize;
 
-    constexpr uint32_t numTimeSteps = 4000;
-    constexpr double tMax = 0.1;
+    // Appropriate chunk size to split your problem for your Acc
+    constexpr Idx xSize = 16u;
+    constexpr Idx ySize = 16u;
+    constexpr alpaka::Vec<Dim, Idx> chunkSize{ySize, xSize};
+
+    // The implicit scheme is unconditionally stable and can use much larger time steps, the adaptive scheme only uses
+    // tMax / numTimeSteps as its first step size. With the steady state detection tMax is only an upper limit and the
+    // simulation stops once the solution has settled.
+    constexpr uint32_t numTimeSteps
+        = timeIntegrator == TimeIntegrator::Explicit ? (steadyStateDetection ? 40000 : 4000) : 100;
+    constexpr double tMax = steadyStateDetection ? 1.0 : 0.1;
+    // Weight of the new time level in the implicit scheme, 0.5 is Crank-Nicolson and 1.0 backward Euler
+    constexpr double theta = 0.5;
 
     // x, y in [0, 1], t in [0, tMax]
     constexpr double dx = 1.0 / static_cast<double>(extent[1] - 1);
     constexpr double dy = 1.0 / static_cast<double>(extent[0] - 1);
     constexpr double dt = tMax / static_cast<double>(numTimeSteps);
 
-    // Check the stability condition
-    double r = 2 * dt / ((dx * dx * dy * dy) / (dx * dx + dy * dy));
-    if(r > 1.)
+    // Check the stability condition, the spectral radius of the five-point stencil is 4 / h^2 per dimension and it
+    // grows with the largest conductivity
+    double r = Stencil::spectralRadius() / 2.0 * dt / ((dx * dx * dy * dy) / (dx * dx + dy * dy))
+               * (variableConductivity ? maxConductivity : 1.0);
+    if(timeIntegrator == TimeIntegrator::Explicit && r > 1.)
     {
         std::cerr << "Stability condition check failed: dt/min(dx^2,dy^2) = " << r
                   << ", it is required to be <= 0.5\n";
         return EXIT_FAILURE;
     }
 
-    // Initialize host-buffer
+    // Pin the threads, the grids are first touched with the mapping of the StencilKernel below. Every chunk is placed
+    // on the NUMA node of the thread that updates it. Only the CPU accelerators run the kernels on the host threads.
+    constexpr bool numaPlacement = numaFirstTouch && std::is_same_v<alpaka::Dev<Acc>, alpaka::DevCpu>;
+    if constexpr(numaPlacement)
+    {
+        std::cout << "Pinned " << pinOpenMpThreads() << " OpenMP threads" << std::endl;
+    }
+
+    // Initialize host-buffer, it is row-major for the output whatever the layout of the accelerator buffers is
     auto uBufHost = alpaka::allocBuf<double, Idx>(devHost, extent);
 
-    // Accelerator buffers
-    auto uCurrBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
-    auto uNextBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+    // Accelerator buffers, dense alpaka buffers, PaddedBuffers with aligned rows or LayoutBuffers with the tiles of
+    // the chunks. The kernels get them as mdspans, see getGridMdSpan.
+    auto allocGridBuf = [&]()
+    {
+        if constexpr(gridRowAlignment > 0)
+            return PaddedBuffer<alpaka::Dev<Acc>, double, Idx, gridRowAlignment>{devAcc, extent, haloSize[1]};
+        else if constexpr(!rowMajorStorage)
+            return LayoutBuffer<alpaka::Dev<Acc>, double, Idx, StorageLayout>{devAcc, extent, chunkSize, haloSize};
+        else
+            return alpaka::allocBuf<double, Idx>(devAcc, extent);
+    };
+    auto uCurrBufAcc = allocGridBuf();
+    // The in-place update only needs a single grid, uNext shares its memory and the swap after every step has no
+    // effect
+    auto uNextBufAcc = inPlaceUpdate ? uCurrBufAcc : allocGridBuf();
 
     // Set buffer to initial conditions
     InitializeBufferKernel initBufferKernel;
@@ -99,7 +340,7 @@ auto example(TAccTag const&) -> int
         cfgExtent,
         devAcc,
         initBufferKernel,
-        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        getGridMdSpan(uCurrBufAcc),
         dx,
         dy);
 
@@ -108,21 +349,14 @@ auto example(TAccTag const&) -> int
     using QueueAcc = alpaka::Queue<Acc, QueueProperty>;
     QueueAcc dumpQueue{devAcc};
     QueueAcc computeQueue{devAcc};
+    // Tracks of the queues in the timeline of ENABLE_TRACING, see Trace.hpp
+    QueueTracer computeTracer{computeQueue, "computeQueue"};
+    QueueTracer dumpTracer{dumpQueue, "dumpQueue"};
 
-    alpaka::exec<Acc>(
-        computeQueue,
-        workDivExtent,
-        initBufferKernel,
-        alpaka::experimental::getMdSpan(uCurrBufAcc),
-        dx,
-        dy);
-
-    // Appropriate chunk size to split your problem for your Acc
-    constexpr Idx xSize = 16u;
-    constexpr Idx ySize = 16u;
-    constexpr alpaka::Vec<Dim, Idx> chunkSize{ySize, xSize};
-    constexpr auto sharedMemSize = (ySize + 2 * haloSize[0]) * (xSize + 2 * haloSize[1]);
-    StencilKernel<sharedMemSize> stencilKernel;
+    // the padded tile of the StencilKernel is at least as large as the dense tiles of the other kernels
+    constexpr auto sharedMemSize = TileLayout::size(ySize + 2 * haloSize[0], xSize + 2 * haloSize[1], haloSize[1]);
+    StencilKernel<sharedMemSize, Stencil, TileLayout> stencilKernel;
+    ConductivityStencilKernel<sharedMemSize> conductivityStencilKernel;
 
     constexpr alpaka::Vec<Dim, Idx> numChunks{
         alpaka::core::divCeil(numNodes[0], chunkSize[0]),
@@ -137,8 +371,8 @@ auto example(TAccTag const&) -> int
     auto const kernelFunctionAttributes = alpaka::getFunctionAttributes<Acc>(
         devAcc,
         stencilKernel,
-        alpaka::experimental::getMdSpan(uCurrBufAcc),
-        alpaka::experimental::getMdSpan(uNextBufAcc),
+        getGridMdSpan(uCurrBufAcc),
+        getGridMdSpan(uNextBufAcc),
         chunkSize,
         haloSize,
         dx,
@@ -151,83 +385,523 @@ auto example(TAccTag const&) -> int
 
     alpaka::WorkDivMembers<Dim, Idx> workDivCore{numChunks, threadsPerBlock, elemPerThread};
 
+    if constexpr(numaPlacement)
+    {
+        for(auto* grid : {&uCurrBufAcc, &uNextBufAcc})
+        {
+            alpaka::exec<Acc>(
+                computeQueue,
+                workDivCore,
+                FirstTouchKernel{},
+                getGridMdSpan(*grid),
+                chunkSize,
+                haloSize);
+        }
+    }
+
+    alpaka::exec<Acc>(
+        computeQueue,
+        workDivExtent,
+        initBufferKernel,
+        getGridMdSpan(uCurrBufAcc),
+        dx,
+        dy);
+
+    // Conductivity of the material, only allocated if it varies in space
+    std::optional<decltype(uCurrBufAcc)> kBufAcc;
+    if constexpr(variableConductivity)
+    {
+        kBufAcc.emplace(alpaka::allocBuf<double, Idx>(devAcc, extent));
+        if constexpr(numaPlacement)
+        {
+            alpaka::exec<Acc>(
+                computeQueue,
+                workDivCore,
+                FirstTouchKernel{},
+                alpaka::experimental::getMdSpan(*kBufAcc),
+                chunkSize,
+                haloSize);
+        }
+        alpaka::exec<Acc>(
+            computeQueue,
+            workDivExtent,
+            InitializeConductivityKernel{},
+            alpaka::experimental::getMdSpan(*kBufAcc),
+            dx,
+            dy);
+    }
+
+    // Boundary values, the profiles of the separable provider are computed once here
+    Boundary<Acc> boundary{devAcc, extent, dx, dy};
+
+    // Temporal tiling of the explicit scheme, the bands of steps divide the image interval of 100 steps. The tiles of
+    // 2 x 2 chunks have to hold the dependency cone of a band. Only the CPU accelerators profit from the cache reuse,
+    // the others keep the plain stepping.
+    constexpr bool cpuTemporalTiling = temporalTiling && std::is_same_v<alpaka::Dev<Acc>, alpaka::DevCpu>;
+    constexpr uint32_t stepsPerBand = Stencil::radius == 1 ? 10 : 5;
+    constexpr alpaka::Vec<Dim, Idx> temporalTileSize{2 * ySize, 2 * xSize};
+    static_assert(
+        stepsPerBand * Stencil::radius <= std::min(xSize, ySize),
+        "The band of steps does not fit into the tiles");
+    std::optional<TemporalTiling<Acc, Stencil>> temporalTiler;
+    if constexpr(cpuTemporalTiling)
+    {
+        temporalTiler.emplace(extent, haloSize, temporalTileSize, threadsPerBlock, dx, dy, dt);
+    }
+
+    // Right hand side and solvers of the implicit scheme, only allocated if they are used
+    std::optional<decltype(uCurrBufAcc)> rhsBufAcc;
+    std::optional<ConjugateGradient<Acc, sharedMemSize, xSize * ySize, Stencil>> conjugateGradient;
+    std::optional<Multigrid<Acc, sharedMemSize, xSize * ySize>> multigrid;
+    std::optional<AlternatingDirectionImplicit<Acc>> alternatingDirectionImplicit;
+    std::optional<RungeKuttaChebyshev<Acc, sharedMemSize, xSize * ySize, Stencil>> rungeKuttaChebyshev;
+    std::optional<TileActivity<Acc, sharedMemSize, Stencil>> tileActivity;
+    std::optional<InPlaceUpdate<Acc, sharedMemSize, Stencil, TileLayout>> inPlaceUpdater;
+    if constexpr(
+        timeIntegrator == TimeIntegrator::ImplicitCG || timeIntegrator == TimeIntegrator::ImplicitMG
+        || timeIntegrator == TimeIntegrator::ImplicitMGCG)
+    {
+        rhsBufAcc.emplace(alpaka::allocBuf<double, Idx>(devAcc, extent));
+    }
+    if constexpr(timeIntegrator == TimeIntegrator::ImplicitCG || timeIntegrator == TimeIntegrator::ImplicitMGCG)
+    {
+        conjugateGradient.emplace(devAcc, extent, workDivCore, chunkSize, haloSize, dx, dy, theta * dt);
+    }
+    if constexpr(timeIntegrator == TimeIntegrator::ImplicitMG || timeIntegrator == TimeIntegrator::ImplicitMGCG)
+    {
+        multigrid.emplace(devAcc, numNodes, threadsPerBlock, chunkSize, haloSize, dx, dy, theta * dt);
+    }
+    if constexpr(timeIntegrator == TimeIntegrator::Adi)
+    {
+        alternatingDirectionImplicit.emplace(devAcc, numNodes, haloSize, dx, dy, dt);
+    }
+    if constexpr(timeIntegrator == TimeIntegrator::AdaptiveRkc)
+    {
+        rungeKuttaChebyshev.emplace(devAcc, extent, workDivCore, chunkSize, haloSize, dx, dy, dt);
+    }
+    if constexpr(tileSkipping)
+    {
+        tileActivity.emplace(devAcc, workDivCore, numChunks, chunkSize, haloSize, dx, dy, dt);
+    }
+    if constexpr(inPlaceUpdate)
+    {
+        inPlaceUpdater.emplace(devAcc, workDivCore, numChunks, chunkSize, haloSize, dx, dy, dt);
+    }
+    uint32_t numSolverIterations = 0;
+
+    // Steady state detection, every monitorInterval steps the largest rate of change max |uNext - uCurr| / dt is
+    // computed by the stencil kernel and the simulation stops once it falls below steadyStateTolerance
+    constexpr uint32_t monitorInterval = 10;
+    constexpr double steadyStateTolerance = 0.1;
+    std::optional<alpaka::Buf<alpaka::Dev<Acc>, double, alpaka::DimInt<1u>, Idx>> maxChangeBufAcc;
+    auto maxChangeBufHost = alpaka::allocBuf<double, Idx>(devHost, Idx{1});
+    if constexpr(steadyStateDetection)
+    {
+        maxChangeBufAcc.emplace(alpaka::allocBuf<double, Idx>(devAcc, Idx{1}));
+    }
+    // pairs of time step and rate of change
+    std::vector<std::pair<uint32_t, double>> rateOfChangeHistory;
+    bool steadyStateReached = false;
+
+    // Hardware performance counters of the threads of the CPU accelerators, counted over the simulation loop and per
+    // kernel of the plain explicit scheme. The kernel regions wait for the queue after every kernel.
+    constexpr bool cpuPerfCounters = perfCounters && std::is_same_v<alpaka::Dev<Acc>, alpaka::DevCpu>;
+    constexpr double numCoreCells = static_cast<double>(numNodes.prod());
+    std::optional<PerfCounters> hardwareCounters;
+    if constexpr(cpuPerfCounters)
+    {
+        hardwareCounters.emplace();
+        hardwareCounters->begin(computeQueue, "simulation loop");
+    }
+
     // Timing start
     auto startTime = std::chrono::high_resolution_clock::now();
 
-    // Simulate
-    for(uint32_t step = 1; step <= numTimeSteps; ++step)
+    // Simulate, the adaptive scheme runs until it reaches tMax
+    double time = 0.0;
+    for(uint32_t step = 1; timeIntegrator == TimeIntegrator::AdaptiveRkc ? time < tMax : step <= numTimeSteps; ++step)
     {
         if(!enableTiming)
         {
 #ifdef PNGWRITER_ENABLED
             if((step - 1) % 100 == 0)
             {
-                alpaka::wait(computeQueue);
-                alpaka::memcpy(dumpQueue, uBufHost, uCurrBufAcc);
+                traceWait(computeQueue, "wait computeQueue");
+                dumpTracer.begin("copy to host");
+                copyGridToHost(dumpQueue, uBufHost, uCurrBufAcc);
+                dumpTracer.end();
+                // the in-place update overwrites the grid that is copied
+                if constexpr(inPlaceUpdate)
+                    traceWait(dumpQueue, "wait dumpQueue");
             }
 #endif
         }
 
-        // Compute next values
-        alpaka::exec<Acc>(
-            computeQueue,
-            workDivCore,
-            stencilKernel,
-            alpaka::experimental::getMdSpan(uCurrBufAcc),
-            alpaka::experimental::getMdSpan(uNextBufAcc),
-            chunkSize,
-            haloSize,
-            dx,
-            dy,
-            dt);
+        computeTracer.begin("step");
+        if constexpr(timeIntegrator == TimeIntegrator::Explicit)
+        {
+            // Compute next values
+            if constexpr(variableConductivity)
+            {
+                alpaka::exec<Acc>(
+                    computeQueue,
+                    workDivCore,
+                    conductivityStencilKernel,
+                    getGridMdSpan(uCurrBufAcc),
+                    getGridMdSpan(uNextBufAcc),
+                    alpaka::experimental::getMdSpan(*kBufAcc),
+                    chunkSize,
+                    haloSize,
+                    dx,
+                    dy,
+                    dt);
+            }
+            else if constexpr(tileSkipping)
+            {
+                tileActivity->step(computeQueue, uCurrBufAcc, uNextBufAcc);
+            }
+            else if constexpr(inPlaceUpdate)
+            {
+                inPlaceUpdater->step(computeQueue, getGridMdSpan(uCurrBufAcc));
+            }
+            else if constexpr(cpuTemporalTiling)
+            {
+                // the whole band is advanced at its first step, the steps of the band only swap the buffers
+                if((step - 1) % stepsPerBand == 0)
+                {
+                    temporalTiler->advance(
+                        computeQueue,
+                        getGridMdSpan(uCurrBufAcc),
+                        getGridMdSpan(uNextBufAcc),
+                        step,
+                        std::min(stepsPerBand, numTimeSteps - step + 1));
+                }
+            }
+            else if(steadyStateDetection && step % monitorInterval == 0)
+            {
+                alpaka::memset(computeQueue, *maxChangeBufAcc, 0u);
+                alpaka::exec<Acc>(
+                    computeQueue,
+                    workDivCore,
+                    stencilKernel,
+                    getGridMdSpan(uCurrBufAcc),
+                    getGridMdSpan(uNextBufAcc),
+                    chunkSize,
+                    haloSize,
+                    dx,
+                    dy,
+                    dt,
+                    alpaka::getPtrNative(*maxChangeBufAcc));
+                alpaka::memcpy(computeQueue, maxChangeBufHost, *maxChangeBufAcc);
+                alpaka::wait(computeQueue);
 
-        // Apply boundaries
-        applyBoundaries<Acc>(
-            workDivExtent,
-            computeQueue,
-            alpaka::experimental::getMdSpan(uNextBufAcc),
-            step,
-            dx,
-            dy,
-            dt);
+                double const rateOfChange = *alpaka::getPtrNative(maxChangeBufHost) / dt;
+                rateOfChangeHistory.emplace_back(step, rateOfChange);
+                if(rateOfChange < steadyStateTolerance)
+                {
+                    steadyStateReached = true;
+                    time = step * dt;
+                }
+            }
+            else
+            {
+                if constexpr(cpuPerfCounters)
+                    hardwareCounters->begin(computeQueue, "StencilKernel");
+                alpaka::exec<Acc>(
+                    computeQueue,
+                    workDivCore,
+                    stencilKernel,
+                    getGridMdSpan(uCurrBufAcc),
+                    getGridMdSpan(uNextBufAcc),
+                    chunkSize,
+                    haloSize,
+                    dx,
+                    dy,
+                    dt);
+                if constexpr(cpuPerfCounters)
+                    hardwareCounters->end(computeQueue, "StencilKernel", numCoreCells);
+            }
+
+            // Apply boundaries, the temporal tiling sets them at every step of the band
+            if constexpr(!cpuTemporalTiling)
+            {
+                if constexpr(cpuPerfCounters)
+                    hardwareCounters->begin(computeQueue, "boundary");
+                boundary.apply(
+                    computeQueue,
+                    workDivExtent,
+                    getGridMdSpan(uNextBufAcc),
+                    haloSize,
+                    step * dt);
+                if constexpr(cpuPerfCounters)
+                    hardwareCounters->end(computeQueue, "boundary", numCoreCells);
+            }
+        }
+        else if constexpr(timeIntegrator == TimeIntegrator::Adi)
+        {
+            alternatingDirectionImplicit->step(computeQueue, workDivExtent, boundary, uCurrBufAcc, uNextBufAcc, step);
+        }
+        else if constexpr(timeIntegrator == TimeIntegrator::AdaptiveRkc)
+        {
+            time = rungeKuttaChebyshev
+                       ->step(computeQueue, workDivExtent, boundary, uCurrBufAcc, uNextBufAcc, time, tMax);
+        }
+        else
+        {
+            // Explicit part of the step, rhs = (I + (1 - theta) * dt * L) uCurr
+            alpaka::exec<Acc>(
+                computeQueue,
+                workDivCore,
+                stencilKernel,
+                getGridMdSpan(uCurrBufAcc),
+                alpaka::experimental::getMdSpan(*rhsBufAcc),
+                chunkSize,
+                haloSize,
+                dx,
+                dy,
+                (1.0 - theta) * dt);
+
+            // The current values are the initial guess, the boundaries are fixed to the values at the next step
+            alpaka::memcpy(computeQueue, uNextBufAcc, uCurrBufAcc);
+            boundary.apply(
+                computeQueue,
+                workDivExtent,
+                getGridMdSpan(uNextBufAcc),
+                haloSize,
+                step * dt);
+
+            // Implicit part of the step, (I - theta * dt * L) uNext = rhs
+            if constexpr(timeIntegrator == TimeIntegrator::ImplicitCG)
+                numSolverIterations += conjugateGradient->solve(computeQueue, uNextBufAcc, *rhsBufAcc);
+            else if constexpr(timeIntegrator == TimeIntegrator::ImplicitMG)
+                numSolverIterations += multigrid->solve(computeQueue, uNextBufAcc, *rhsBufAcc);
+            else
+                numSolverIterations += conjugateGradient->solve(computeQueue, uNextBufAcc, *rhsBufAcc, *multigrid);
+        }
+        computeTracer.end();
 
         if(!enableTiming)
         {
 #ifdef PNGWRITER_ENABLED
             if((step - 1) % 100 == 0)
             {
-                alpaka::wait(dumpQueue);
+                traceWait(dumpQueue, "wait dumpQueue");
+                TraceScope const imageTrace{"writeImage"};
                 writeImage(step - 1, uBufHost);
             }
 #endif
         }
         // Swap next and curr (shallow copy)
         std::swap(uNextBufAcc, uCurrBufAcc);
+
+        if(steadyStateReached)
+            break;
+    }
+    traceWait(computeQueue, "wait computeQueue");
+    if constexpr(cpuPerfCounters)
+    {
+        uint32_t const numStepsDone = steadyStateReached ? rateOfChangeHistory.back().first : numTimeSteps;
+        hardwareCounters->end(computeQueue, "simulation loop", numCoreCells * numStepsDone);
     }
-    alpaka::wait(computeQueue);
 
     // Timing end
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsedTime = endTime - startTime;
     if(enableTiming)
     {
-        auto endTime = std::chrono::high_resolution_clock::now();
-        std::chrono::duration<double> elapsedTime = endTime - startTime;
         if(enableTiming)
         {
             std::cout << "Simulation took " << elapsedTime.count() << " seconds." << std::endl;
         }
+        if constexpr(cpuPerfCounters)
+            hardwareCounters->report();
+        // smallest number of steps the explicit scheme needs to stay stable
+        auto const numExplicitTimeSteps = static_cast<uint32_t>(std::ceil(numTimeSteps * r));
+        if constexpr(timeIntegrator == TimeIntegrator::AdaptiveRkc)
+        {
+            std::cout << "Adaptive scheme accepted " << rungeKuttaChebyshev->numAcceptedSteps() << " and rejected "
+                      << rungeKuttaChebyshev->numRejectedSteps() << " time steps with "
+                      << rungeKuttaChebyshev->numStages() << " stages in total, the explicit scheme needs at least "
+                      << numExplicitTimeSteps << " time steps." << std::endl;
+        }
+        else if constexpr(tileSkipping)
+        {
+            std::cout << "Updated " << tileActivity->numTileUpdates(computeQueue) << " of "
+                      << numTimeSteps * numChunks.prod() << " tiles, the others were skipped as unchanged."
+                      << std::endl;
+        }
+        else if constexpr(timeIntegrator != TimeIntegrator::Explicit)
+        {
+            std::cout << "Implicit scheme used " << numTimeSteps << " time steps";
+            if constexpr(timeIntegrator == TimeIntegrator::ImplicitMG)
+                std::cout << " with " << numSolverIterations << " multigrid V-cycles";
+            else if constexpr(timeIntegrator != TimeIntegrator::Adi)
+                std::cout << " with " << numSolverIterations << " conjugate gradient iterations";
+            std::cout << ", the explicit scheme needs at least " << numExplicitTimeSteps << " time steps."
+                      << std::endl;
+        }
+    }
+
+    if constexpr(steadyStateDetection)
+    {
+        if(steadyStateReached)
+            std::cout << "Steady state reached after " << rateOfChangeHistory.back().first << " of " << numTimeSteps
+                      << " time steps." << std::endl;
+        else
+            std::cout << "Steady state not reached within " << numTimeSteps << " time steps." << std::endl;
+        // every hundredth entry of the history and the last one
+        std::cout << "Largest rate of change max |uNext - uCurr| / dt:" << std::endl;
+        for(size_t i = 0; i < rateOfChangeHistory.size(); ++i)
+        {
+            if(i % 100 == 0 || i + 1 == rateOfChangeHistory.size())
+                std::cout << "  step " << rateOfChangeHistory[i].first << ": " << rateOfChangeHistory[i].second
+                          << std::endl;
+        }
+    }
+
+    if constexpr(numaPlacement)
+    {
+        // the node of every chunk, with the same work division the blocks run on the same threads as the StencilKernel
+        auto chunkNodesBufAcc = alpaka::allocBuf<int, Idx>(devAcc, numChunks.prod());
+        alpaka::exec<Acc>(computeQueue, workDivCore, ThreadNodeKernel{}, alpaka::getPtrNative(chunkNodesBufAcc));
+        alpaka::wait(computeQueue);
+        int const* const chunkNodes = alpaka::getPtrNative(chunkNodesBufAcc);
+        reportNumaPlacement("uCurr", getGridView(uCurrBufAcc), numChunks, chunkSize, haloSize, chunkNodes);
+        reportNumaPlacement("uNext", getGridView(uNextBufAcc), numChunks, chunkSize, haloSize, chunkNodes);
     }
 
     // Copy device -> host
-    alpaka::memcpy(dumpQueue, uBufHost, uCurrBufAcc);
-    alpaka::wait(dumpQueue);
+    dumpTracer.begin("copy to host");
+    copyGridToHost(dumpQueue, uBufHost, uCurrBufAcc);
+    dumpTracer.end();
+    traceWait(dumpQueue, "wait dumpQueue");
+
+    // Validate, the analytical solution only holds for a uniform conductivity
+    double const tEnd = steadyStateReached ? time : tMax;
+    auto const [resultIsCorrect, maxError] = variableConductivity ? validateMaximumPrinciple(uBufHost)
+                                                                  : validateSolution(uBufHost, dx, dy, tEnd);
+
+    // Share of the attainable bandwidth of the stencil, the boundary pass and the dump copies, every one is timed on
+    // its own once the results are copied and validated. The bandwidth is probed with arrays of the size of the grid,
+    // so the kernels and the probe share the level of the memory hierarchy, the caches of CPUs for the default grid.
+    // The probe runs once per process, see attainableBandwidth. The other modes launch other kernels, no share then.
+    constexpr double numBoundaryCells = static_cast<double>(extent.prod() - numNodes.prod());
+    if constexpr(enableTiming && plainStencilSteps)
+    {
+        constexpr uint32_t numBandwidthLaunches = 20;
+        auto const attainable = attainableBandwidth<Acc>(devAcc, extent.prod());
+        std::cout << "Attainable bandwidth with arrays of the grid size (" << extent.prod() << " elements): copy "
+                  << attainable.copy / 1e9 << " GB/s, scale " << attainable.scale / 1e9 << " GB/s, triad "
+                  << attainable.triad / 1e9 << " GB/s, device to host " << attainable.deviceToHost / 1e9 << " GB/s"
+                  << std::endl;
+
+        double const stencilSeconds = timeLaunches(
+            computeQueue,
+            numBandwidthLaunches,
+            [&]()
+            {
+                alpaka::exec<Acc>(
+                    computeQueue,
+                    workDivCore,
+                    stencilKernel,
+                    getGridMdSpan(uCurrBufAcc),
+                    getGridMdSpan(uNextBufAcc),
+                    chunkSize,
+                    haloSize,
+                    dx,
+                    dy,
+                    dt);
+            });
+        double const boundarySeconds = timeLaunches(
+            computeQueue,
+            numBandwidthLaunches,
+            [&]() { boundary.apply(computeQueue, workDivExtent, getGridMdSpan(uNextBufAcc), haloSize, tEnd); });
+        double const dumpSeconds = timeLaunches(
+            dumpQueue,
+            numBandwidthLaunches,
+            [&]() { copyGridToHost(dumpQueue, uBufHost, uCurrBufAcc); });
+
+        reportBandwidthShare(
+            "StencilKernel",
+            decltype(stencilKernel)::bytesPerCell * numCoreCells,
+            stencilSeconds,
+            attainable.peak());
+        reportBandwidthShare(
+            "boundary",
+            Boundary<Acc>::Kernel::bytesPerCell * numBoundaryCells,
+            boundarySeconds,
+            attainable.peak());
+        // the copy from a CPU device into host memory reads and writes the same memory like the STREAM copy, the
+        // copy from another device is bound by the transfer to the host
+        constexpr bool hostDevice = std::is_same_v<alpaka::Dev<Acc>, alpaka::DevCpu>;
+        reportBandwidthShare(
+            "copy to host",
+            (hostDevice ? 2.0 : 1.0) * static_cast<double>(sizeof(double) * extent.prod()),
+            dumpSeconds,
+            hostDevice ? attainable.copy : attainable.deviceToHost);
+    }
 
-    // Validate
-    auto const [resultIsCorrect, maxError] = validateSolution(uBufHost, dx, dy, tMax);
+    // Roofline of the kernels, every kernel is timed on its own once the results are copied and validated
+    int benchmarkResult = EXIT_SUCCESS;
+    if constexpr(roofline)
+    {
+        Roofline<Acc> kernelRoofline{devAcc, extent.prod()};
+        kernelRoofline.measure(
+            computeQueue,
+            "InitializeBufferKernel",
+            kernelCost<InitializeBufferKernel>(),
+            static_cast<double>(extent.prod()),
+            [&]()
+            { alpaka::exec<Acc>(computeQueue, workDivExtent, initBufferKernel, getGridMdSpan(uCurrBufAcc), dx, dy); });
+        kernelRoofline.measure(
+            computeQueue,
+            "StencilKernel",
+            kernelCost<decltype(stencilKernel)>(),
+            numCoreCells,
+            [&]()
+            {
+                alpaka::exec<Acc>(
+                    computeQueue,
+                    workDivCore,
+                    stencilKernel,
+                    getGridMdSpan(uCurrBufAcc),
+                    getGridMdSpan(uNextBufAcc),
+                    chunkSize,
+                    haloSize,
+                    dx,
+                    dy,
+                    dt);
+            });
+        kernelRoofline.measure(
+            computeQueue,
+            "boundary",
+            kernelCost<typename Boundary<Acc>::Kernel>(),
+            numBoundaryCells,
+            [&]() { boundary.apply(computeQueue, workDivExtent, getGridMdSpan(uNextBufAcc), haloSize, tEnd); });
+        // the volatile store keeps the compiler from dropping the repeated validation
+        volatile double validationError = 0.0;
+        kernelRoofline.measureHost(
+            "validateSolution",
+            kernelCost<ValidationCost>(),
+            numCoreCells,
+            [&]() { validationError = validateSolution(uBufHost, dx, dy, tEnd).second; });
+        kernelRoofline.report();
+
+        // Performance regression test of the lattice updates per second and the kernel times, see Benchmark.hpp
+        if constexpr(benchmark)
+        {
+            std::vector<BenchmarkMetric> metrics{
+                {"MLUP/s", numCoreCells * numTimeSteps / elapsedTime.count() / 1e6, true}};
+            for(auto const& entry : kernelRoofline.entries())
+                metrics.push_back({entry.name + " [us]", entry.seconds * 1e6, false});
+            benchmarkResult = compareToBaseline(TAccTag::get_name(), metrics);
+        }
+    }
 
     if(resultIsCorrect)
     {
         std::cout << "Execution results correct!" << std::endl;
-        return EXIT_SUCCESS;
+        return benchmarkResult;
     }
     else
     {
@@ -237,10 +911,12 @@ auto example(TAccTag const&) -> int
     }
 }
 
-auto main() -> int
+auto main(int argc, char* argv[]) -> int
 {
-    // Execute the example once for each enabled accelerator.
-    // If you would like to execute it for a single accelerator only you can use
+    // Execute the example for the accelerator selected with --accelerator <name> or HEAT_EQUATION_ACCELERATOR,
+    // otherwise once for each enabled accelerator, see AcceleratorSelection.hpp. --list-accelerators prints the
+    // enabled accelerators and their devices.
+    // If you would like to always execute it for a single accelerator only you can use
     // the following code.
     //  \code{.cpp}
     //  auto tag = alpaka::TagCpuSerial{};
@@ -251,5 +927,5 @@ auto main() -> int
     //   TagCpuSerial, TagGpuHipRt, TagGpuCudaRt, TagCpuOmp2Blocks,
     //   TagCpuTbbBlocks, TagCpuOmp2Threads, TagCpuSycl, TagCpuTbbBlocks,
     //   TagCpuThreads, TagFpgaSyclIntel, TagGenericSycl, TagGpuSyclIntel
-    return alpaka::executeForEachAccTag([=](auto const& tag) { return example(tag); });
+    return executeForSelectedAccTag(argc, argv, [=](auto const& tag) { return example(tag); });
 }
@@ -0,0 +1,243 @@
+/* Copyright 2024 Benjamin Worpitz, Matthias Werner, Jakob Krude, Sergei
+ * Bastrakov, Bernhard Manfred Gruber, Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#include "AcceleratorSelection.hpp"
+#include "BoundaryKernel.hpp"
+#include "InitializeBufferKernel.hpp"
+#include "Stencil.hpp"
+#include "StencilKernel3D.hpp"
+#include "analyticalSolution.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#ifdef ENABLE_TIMING
+constexpr bool enableTiming = true;
+#else
+constexpr bool enableTiming = false;
+#endif
+
+//! Finite-difference stencil of the Laplacian along each dimension, the five-point stencil gives seven points in 3D
+#if defined(STENCIL_NINE_POINT)
+using Stencil = NinePointStencil;
+#elif defined(STENCIL_THIRTEEN_POINT)
+using Stencil = ThirteenPointStencil;
+#else
+using Stencil = FivePointStencil;
+#endif
+
+//! 3D version of the heat equation example with the explicit scheme
+//!
+//! Every block streams through a chunk of {Z, Y, X} cells along z, see the StencilKernel3D. The blocks are 2D in
+//! {Y, X}, the grid of blocks covers the chunks in all three dimensions.
+template<typename TAccTag>
+auto example(TAccTag const&) -> int
+{
+    // Set Dim and Idx type
+    using Dim = alpaka::DimInt<3u>;
+    using Idx = uint32_t;
+
+    // Define the accelerator
+    using Acc = alpaka::TagToAcc<TAccTag, Dim, Idx>;
+    std::cout << "Using alpaka accelerator: " << alpaka::getAccName<Acc>() << std::endl;
+
+    // Select specific devices
+    auto const platformHost = alpaka::PlatformCpu{};
+    auto const devHost = alpaka::getDevByIdx(platformHost, 0);
+    auto const platformAcc = alpaka::Platform<Acc>{};
+    // get suitable device for this Acc
+    auto const devAcc = alpaka::getDevByIdx(platformAcc, 0);
+
+    // simulation defines
+    // {Z, Y, X}
+    constexpr Idx numNodesPerDim = Stencil::radius == 1 ? 64 : 32;
+    constexpr alpaka::Vec<Dim, Idx> numNodes{numNodesPerDim, numNodesPerDim, numNodesPerDim};
+    // Size of halo required for our stencil in {Z, Y, X} (below, above and to the left).
+    constexpr alpaka::Vec<Dim, Idx> haloSize{Stencil::radius, Stencil::radius, Stencil::radius};
+    // Halo size must be multiplied by two to get the extents, as their are halo cells on the other side as well
+    constexpr alpaka::Vec<Dim, Idx> extent = numNodes + haloSize + haloSize;
+
+    constexpr uint32_t numTimeSteps = 4000;
+    constexpr double tMax = 0.1;
+
+    // x, y, z in [0, 1], t in [0, tMax]
+    constexpr double dx = 1.0 / static_cast<double>(extent[2] - 1);
+    constexpr double dy = 1.0 / static_cast<double>(extent[1] - 1);
+    constexpr double dz = 1.0 / static_cast<double>(extent[0] - 1);
+    constexpr double dt = tMax / static_cast<double>(numTimeSteps);
+
+    // Check the stability condition, forward Euler requires dt * spectral radius <= 2
+    double const r = Stencil::spectralRadius() / 2.0 * dt * (1.0 / (dx * dx) + 1.0 / (dy * dy) + 1.0 / (dz * dz));
+    if(r > 1.)
+    {
+        std::cerr << "Stability condition check failed: dt * spectral radius / 2 = " << r
+                  << ", it is required to be <= 1\n";
+        return EXIT_FAILURE;
+    }
+
+    // Initialize host-buffer
+    auto uBufHost = alpaka::allocBuf<double, Idx>(devHost, extent);
+
+    // Accelerator buffers
+    auto uCurrBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+    auto uNextBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+
+    // Set buffer to initial conditions
+    InitializeBufferKernel initBufferKernel;
+    // Define a workdiv for the given problem
+    constexpr alpaka::Vec<Dim, Idx> elemPerThread{1, 1, 1};
+
+    alpaka::KernelCfg<Acc> const cfgExtent = {extent, elemPerThread};
+
+    auto workDivExtent = alpaka::getValidWorkDiv(
+        cfgExtent,
+        devAcc,
+        initBufferKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        dx,
+        dy,
+        dz);
+
+    // Create queues
+    using QueueProperty = alpaka::NonBlocking;
+    using QueueAcc = alpaka::Queue<Acc, QueueProperty>;
+    QueueAcc dumpQueue{devAcc};
+    QueueAcc computeQueue{devAcc};
+
+    alpaka::exec<Acc>(
+        computeQueue,
+        workDivExtent,
+        initBufferKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        dx,
+        dy,
+        dz);
+
+    // Appropriate chunk size to split your problem for your Acc, every block streams through zSize planes
+    constexpr Idx xSize = 16u;
+    constexpr Idx ySize = 16u;
+    constexpr Idx zSize = 16u;
+    constexpr alpaka::Vec<Dim, Idx> chunkSize{zSize, ySize, xSize};
+    // queue of 2 * radius + 1 planes of the xy tile including the halo
+    constexpr auto sharedMemSize
+        = (2 * Stencil::radius + 1) * (ySize + 2 * haloSize[1]) * (xSize + 2 * haloSize[2]);
+    StencilKernel3D<sharedMemSize, Stencil> stencilKernel;
+
+    constexpr alpaka::Vec<Dim, Idx> numChunks{
+        alpaka::core::divCeil(numNodes[0], chunkSize[0]),
+        alpaka::core::divCeil(numNodes[1], chunkSize[1]),
+        alpaka::core::divCeil(numNodes[2], chunkSize[2]),
+    };
+
+    assert(
+        numNodes[0] % chunkSize[0] == 0 && numNodes[1] % chunkSize[1] == 0 && numNodes[2] % chunkSize[2] == 0
+        && "Domain must be divisible by chunk size");
+
+    // Get max threads that can be run in a block for this kernel
+    auto const kernelFunctionAttributes = alpaka::getFunctionAttributes<Acc>(
+        devAcc,
+        stencilKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        alpaka::experimental::getMdSpan(uNextBufAcc),
+        chunkSize,
+        haloSize,
+        dx,
+        dy,
+        dz,
+        dt);
+    auto const maxThreadsPerBlock = kernelFunctionAttributes.maxThreadsPerBlock;
+
+    // a single thread in z, the threads of a block share the xy planes
+    auto const threadsPerBlock = maxThreadsPerBlock < ySize * xSize ? alpaka::Vec<Dim, Idx>{1, maxThreadsPerBlock, 1}
+                                                                    : alpaka::Vec<Dim, Idx>{1, ySize, xSize};
+
+    alpaka::WorkDivMembers<Dim, Idx> workDivCore{numChunks, threadsPerBlock, elemPerThread};
+
+    // Timing start
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Simulate
+    for(uint32_t step = 1; step <= numTimeSteps; ++step)
+    {
+        // Compute next values
+        alpaka::exec<Acc>(
+            computeQueue,
+            workDivCore,
+            stencilKernel,
+            alpaka::experimental::getMdSpan(uCurrBufAcc),
+            alpaka::experimental::getMdSpan(uNextBufAcc),
+            chunkSize,
+            haloSize,
+            dx,
+            dy,
+            dz,
+            dt);
+
+        // Apply boundaries
+        applyBoundaries<Acc>(
+            workDivExtent,
+            computeQueue,
+            alpaka::experimental::getMdSpan(uNextBufAcc),
+            haloSize,
+            step,
+            dx,
+            dy,
+            dz,
+            dt);
+
+        // Swap next and curr (shallow copy)
+        std::swap(uNextBufAcc, uCurrBufAcc);
+    }
+    alpaka::wait(computeQueue);
+
+    // Timing end
+    if(enableTiming)
+    {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsedTime = endTime - startTime;
+        std::cout << "Simulation took " << elapsedTime.count() << " seconds." << std::endl;
+    }
+
+    // Copy device -> host
+    alpaka::memcpy(dumpQueue, uBufHost, uCurrBufAcc);
+    alpaka::wait(dumpQueue);
+
+    // Validate
+    auto const [resultIsCorrect, maxError] = validateSolution(uBufHost, dx, dy, dz, tMax);
+
+    if(resultIsCorrect)
+    {
+        std::cout << "Execution results correct!" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        std::cout << "Execution results incorrect: Max error = " << maxError << " (the grid resolution may be too low)"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    // Execute the example for the accelerator selected with --accelerator <name> or HEAT_EQUATION_ACCELERATOR,
+    // otherwise once for each enabled accelerator, see AcceleratorSelection.hpp. --list-accelerators prints the
+    // enabled accelerators and their devices.
+    // If you would like to always execute it for a single accelerator only you can use
+    // the following code.
+    //  \code{.cpp}
+    //  auto tag = alpaka::TagCpuSerial{};
+    //  return example(tag);
+    //  \endcode
+    //
+    // valid tags:
+    //   TagCpuSerial, TagGpuHipRt, TagGpuCudaRt, TagCpuOmp2Blocks,
+    //   TagCpuTbbBlocks, TagCpuOmp2Threads, TagCpuSycl, TagCpuTbbBlocks,
+    //   TagCpuThreads, TagFpgaSyclIntel, TagGenericSycl, TagGpuSyclIntel
+    return executeForSelectedAccTag(argc, argv, [=](auto const& tag) { return example(tag); });
+}
@@ -0,0 +1,249 @@
+/* Copyright 2024 Benjamin Worpitz, Matthias Werner, Jakob Krude, Sergei
+ * Bastrakov, Bernhard Manfred Gruber, Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#include "AcceleratorSelection.hpp"
+#include "AdaptiveMeshRefinement.hpp"
+#include "BoundaryKernel.hpp"
+#include "InitializeBufferKernel.hpp"
+#include "StencilKernel.hpp"
+#include "analyticalSolution.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#ifdef ENABLE_TIMING
+constexpr bool enableTiming = true;
+#else
+constexpr bool enableTiming = false;
+#endif
+
+//! 2D heat equation example with block-structured adaptive mesh refinement and the explicit scheme
+//!
+//! The chunks of the coarse grid with a steep gradient get a fine patch with half the grid spacing, see the
+//! AdaptiveMeshRefinement. The initial condition is steepest in the corners of the domain, the patches follow the
+//! criterion while the solution decays and are dropped once it is smooth everywhere.
+template<typename TAccTag>
+auto example(TAccTag const&) -> int
+{
+    // Set Dim and Idx type
+    using Dim = alpaka::DimInt<2u>;
+    using Idx = uint32_t;
+
+    // Define the accelerator
+    using Acc = alpaka::TagToAcc<TAccTag, Dim, Idx>;
+    std::cout << "Using alpaka accelerator: " << alpaka::getAccName<Acc>() << std::endl;
+
+    // Select specific devices
+    auto const platformHost = alpaka::PlatformCpu{};
+    auto const devHost = alpaka::getDevByIdx(platformHost, 0);
+    auto const platformAcc = alpaka::Platform<Acc>{};
+    // get suitable device for this Acc
+    auto const devAcc = alpaka::getDevByIdx(platformAcc, 0);
+
+    // simulation defines
+    // {Y, X}
+    constexpr alpaka::Vec<Dim, Idx> numNodes{64, 64};
+    // Size of halo required for the five-point stencil in {Y, X}, the interpolation of the patch halos relies on it
+    constexpr alpaka::Vec<Dim, Idx> haloSize{1, 1};
+    constexpr alpaka::Vec<Dim, Idx> extent = numNodes + haloSize + haloSize;
+
+    constexpr uint32_t numTimeSteps = 4000;
+    constexpr double tMax = 0.1;
+
+    // x, y in [0, 1], t in [0, tMax]
+    constexpr double dx = 1.0 / static_cast<double>(extent[1] - 1);
+    constexpr double dy = 1.0 / static_cast<double>(extent[0] - 1);
+    constexpr double dt = tMax / static_cast<double>(numTimeSteps);
+
+    // The patches are evaluated every regridInterval coarse steps, chunks with a larger gradient magnitude are refined
+    constexpr uint32_t regridInterval = 100;
+    constexpr double refinementThreshold = 3.5;
+
+    // Check the stability condition, forward Euler requires dt * spectral radius <= 2. The patches halve the grid
+    // spacing and quarter the time step, so the same condition holds for them.
+    double const r = FivePointStencil::spectralRadius() / 2.0 * dt * (1.0 / (dx * dx) + 1.0 / (dy * dy));
+    if(r > 1.)
+    {
+        std::cerr << "Stability condition check failed: dt * spectral radius / 2 = " << r
+                  << ", it is required to be <= 1\n";
+        return EXIT_FAILURE;
+    }
+
+    // Initialize host-buffer
+    auto uBufHost = alpaka::allocBuf<double, Idx>(devHost, extent);
+
+    // Accelerator buffers
+    auto uCurrBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+    auto uNextBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+
+    // Set buffer to initial conditions
+    InitializeBufferKernel initBufferKernel;
+    // Define a workdiv for the given problem
+    constexpr alpaka::Vec<Dim, Idx> elemPerThread{1, 1};
+
+    alpaka::KernelCfg<Acc> const cfgExtent = {extent, elemPerThread};
+
+    auto workDivExtent = alpaka::getValidWorkDiv(
+        cfgExtent,
+        devAcc,
+        initBufferKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        dx,
+        dy);
+
+    // Create queues
+    using QueueProperty = alpaka::NonBlocking;
+    using QueueAcc = alpaka::Queue<Acc, QueueProperty>;
+    QueueAcc dumpQueue{devAcc};
+    QueueAcc computeQueue{devAcc};
+
+    alpaka::exec<Acc>(
+        computeQueue,
+        workDivExtent,
+        initBufferKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        dx,
+        dy);
+
+    // Appropriate chunk size to split your problem for your Acc, a patch refines one chunk
+    constexpr Idx xSize = 16u;
+    constexpr Idx ySize = 16u;
+    constexpr alpaka::Vec<Dim, Idx> chunkSize{ySize, xSize};
+    constexpr auto sharedMemSize = (ySize + 2 * haloSize[0]) * (xSize + 2 * haloSize[1]);
+    StencilKernel<sharedMemSize> stencilKernel;
+
+    constexpr alpaka::Vec<Dim, Idx> numChunks{
+        alpaka::core::divCeil(numNodes[0], chunkSize[0]),
+        alpaka::core::divCeil(numNodes[1], chunkSize[1]),
+    };
+
+    assert(
+        numNodes[0] % chunkSize[0] == 0 && numNodes[1] % chunkSize[1] == 0
+        && "Domain must be divisible by chunk size");
+
+    // Get max threads that can be run in a block for this kernel
+    auto const kernelFunctionAttributes = alpaka::getFunctionAttributes<Acc>(
+        devAcc,
+        stencilKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        alpaka::experimental::getMdSpan(uNextBufAcc),
+        chunkSize,
+        haloSize,
+        dx,
+        dy,
+        dt);
+    auto const maxThreadsPerBlock = kernelFunctionAttributes.maxThreadsPerBlock;
+
+    auto const threadsPerBlock
+        = maxThreadsPerBlock < chunkSize.prod() ? alpaka::Vec<Dim, Idx>{maxThreadsPerBlock, 1} : chunkSize;
+
+    alpaka::WorkDivMembers<Dim, Idx> workDivCore{numChunks, threadsPerBlock, elemPerThread};
+
+    AdaptiveMeshRefinement<Acc, sharedMemSize, chunkSize.prod()>
+        amr{devAcc, workDivCore, numChunks, chunkSize, haloSize, dx, dy, dt, refinementThreshold};
+
+    // Timing start
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Simulate, the patches are validated before every regrid, most of them are dropped until the end
+    double maxPatchError = 0.0;
+    for(uint32_t step = 1; step <= numTimeSteps; ++step)
+    {
+        if((step - 1) % regridInterval == 0)
+        {
+            maxPatchError = std::max(maxPatchError, amr.maxPatchError(computeQueue, (step - 1) * dt));
+            amr.regrid(computeQueue, uCurrBufAcc);
+        }
+
+        // Compute next values on the coarse grid
+        alpaka::exec<Acc>(
+            computeQueue,
+            workDivCore,
+            stencilKernel,
+            alpaka::experimental::getMdSpan(uCurrBufAcc),
+            alpaka::experimental::getMdSpan(uNextBufAcc),
+            chunkSize,
+            haloSize,
+            dx,
+            dy,
+            dt);
+
+        // Apply boundaries
+        applyBoundaries<Acc>(
+            workDivExtent,
+            computeQueue,
+            alpaka::experimental::getMdSpan(uNextBufAcc),
+            haloSize,
+            step,
+            dx,
+            dy,
+            dt);
+
+        // Subcycle the patches and replace the coarse values they cover
+        amr.step(computeQueue, uCurrBufAcc, uNextBufAcc);
+
+        // Swap next and curr (shallow copy)
+        std::swap(uNextBufAcc, uCurrBufAcc);
+    }
+    alpaka::wait(computeQueue);
+
+    // Timing end
+    if(enableTiming)
+    {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsedTime = endTime - startTime;
+        std::cout << "Simulation took " << elapsedTime.count() << " seconds." << std::endl;
+    }
+    std::cout << "Refined up to " << amr.maxNumPatches() << " of " << numChunks.prod() << " chunks, "
+              << amr.numPatches() << " patches at the end" << std::endl;
+
+    // Copy device -> host
+    alpaka::memcpy(dumpQueue, uBufHost, uCurrBufAcc);
+    alpaka::wait(dumpQueue);
+
+    // Validate the coarse grid and the remaining patches, a run that never refined has not checked any patch
+    auto const [resultIsCorrect, maxError] = validateSolution(uBufHost, dx, dy, tMax);
+    maxPatchError = std::max(maxPatchError, amr.maxPatchError(dumpQueue, tMax));
+
+    if(amr.maxNumPatches() == 0)
+    {
+        std::cout << "Execution results incorrect: no chunk was refined" << std::endl;
+        return EXIT_FAILURE;
+    }
+    if(resultIsCorrect && maxPatchError < 1e-4)
+    {
+        std::cout << "Execution results correct!" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        std::cout << "Execution results incorrect: Max error = " << std::max(maxError, maxPatchError)
+                  << " (the grid resolution may be too low)" << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    // Execute the example for the accelerator selected with --accelerator <name> or HEAT_EQUATION_ACCELERATOR,
+    // otherwise once for each enabled accelerator, see AcceleratorSelection.hpp. --list-accelerators prints the
+    // enabled accelerators and their devices.
+    // If you would like to always execute it for a single accelerator only you can use
+    // the following code.
+    //  \code{.cpp}
+    //  auto tag = alpaka::TagCpuSerial{};
+    //  return example(tag);
+    //  \endcode
+    //
+    // valid tags:
+    //   TagCpuSerial, TagGpuHipRt, TagGpuCudaRt, TagCpuOmp2Blocks,
+    //   TagCpuTbbBlocks, TagCpuOmp2Threads, TagCpuSycl, TagCpuTbbBlocks,
+    //   TagCpuThreads, TagFpgaSyclIntel, TagGenericSycl, TagGpuSyclIntel
+    return executeForSelectedAccTag(argc, argv, [=](auto const& tag) { return example(tag); });
+}
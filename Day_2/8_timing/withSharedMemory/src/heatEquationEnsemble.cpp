@@ -0,0 +1,259 @@
+/* Copyright 2024 Benjamin Worpitz, Matthias Werner, Jakob Krude, Sergei
+ * Bastrakov, Bernhard Manfred Gruber, Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#include "AcceleratorSelection.hpp"
+#include "BoundaryKernel.hpp"
+#include "InitializeBufferKernel.hpp"
+#include "Stencil.hpp"
+#include "StencilKernel.hpp"
+#include "analyticalSolution.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+#ifdef ENABLE_TIMING
+constexpr bool enableTiming = true;
+#else
+constexpr bool enableTiming = false;
+#endif
+
+//! Finite-difference stencil of the Laplacian
+#if defined(STENCIL_NINE_POINT)
+using Stencil = NinePointStencil;
+#elif defined(STENCIL_THIRTEEN_POINT)
+using Stencil = ThirteenPointStencil;
+#else
+using Stencil = FivePointStencil;
+#endif
+
+//! Ensemble version of the 2D heat equation example with the explicit scheme
+//!
+//! numMembers independent simulations with different diffusivities are stacked into buffers of {E, Y, X} cells and
+//! advanced by a single kernel launch per time step. The grid of blocks gets the batch dimension as its slowest
+//! dimension, so the block index selects the member. Small problems fill a large device this way and the launch
+//! overhead is shared by all members.
+template<typename TAccTag>
+auto example(TAccTag const&) -> int
+{
+    // Set Dim and Idx type, the first dimension is the member of the ensemble
+    using Dim = alpaka::DimInt<3u>;
+    using Idx = uint32_t;
+
+    // Define the accelerator
+    using Acc = alpaka::TagToAcc<TAccTag, Dim, Idx>;
+    std::cout << "Using alpaka accelerator: " << alpaka::getAccName<Acc>() << std::endl;
+
+    // Select specific devices
+    auto const platformHost = alpaka::PlatformCpu{};
+    auto const devHost = alpaka::getDevByIdx(platformHost, 0);
+    auto const platformAcc = alpaka::Platform<Acc>{};
+    // get suitable device for this Acc
+    auto const devAcc = alpaka::getDevByIdx(platformAcc, 0);
+
+    // simulation defines
+    // {E, Y, X}
+    constexpr Idx numMembers = 16;
+    constexpr Idx numNodesPerDim = Stencil::radius == 1 ? 64 : 32;
+    constexpr alpaka::Vec<Dim, Idx> numNodes{numMembers, numNodesPerDim, numNodesPerDim};
+    // Size of halo required for our stencil in {E, Y, X}, the members are independent and need no halo
+    constexpr alpaka::Vec<Dim, Idx> haloSize{0, Stencil::radius, Stencil::radius};
+    constexpr alpaka::Vec<Dim, Idx> extent = numNodes + haloSize + haloSize;
+
+    constexpr uint32_t numTimeSteps = 4000;
+    constexpr double tMax = 0.1;
+
+    // x, y in [0, 1], t in [0, tMax]
+    constexpr double dx = 1.0 / static_cast<double>(extent[2] - 1);
+    constexpr double dy = 1.0 / static_cast<double>(extent[1] - 1);
+    constexpr double dt = tMax / static_cast<double>(numTimeSteps);
+
+    // The members differ in their diffusivity, which is spread evenly over [minDiffusivity, maxDiffusivity]
+    constexpr double minDiffusivity = 0.5;
+    constexpr double maxDiffusivity = 1.0;
+    auto diffusivityBufHost = alpaka::allocBuf<double, Idx>(devHost, numMembers);
+    double* const diffusivityHost = alpaka::getPtrNative(diffusivityBufHost);
+    for(Idx member = 0; member < numMembers; ++member)
+    {
+        diffusivityHost[member]
+            = minDiffusivity + (maxDiffusivity - minDiffusivity) * member / static_cast<double>(numMembers - 1);
+    }
+
+    // Check the stability condition for the member with the largest diffusivity
+    double const r = Stencil::spectralRadius() / 2.0 * maxDiffusivity * dt * (1.0 / (dx * dx) + 1.0 / (dy * dy));
+    if(r > 1.)
+    {
+        std::cerr << "Stability condition check failed: dt * spectral radius / 2 = " << r
+                  << ", it is required to be <= 1\n";
+        return EXIT_FAILURE;
+    }
+
+    // Initialize host-buffer
+    auto uBufHost = alpaka::allocBuf<double, Idx>(devHost, extent);
+
+    // Accelerator buffers
+    auto uCurrBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+    auto uNextBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+    auto diffusivityBufAcc = alpaka::allocBuf<double, Idx>(devAcc, numMembers);
+
+    // Set buffer to initial conditions
+    InitializeBufferKernel initBufferKernel;
+    // Define a workdiv for the given problem
+    constexpr alpaka::Vec<Dim, Idx> elemPerThread{1, 1, 1};
+
+    alpaka::KernelCfg<Acc> const cfgExtent = {extent, elemPerThread};
+
+    auto workDivExtent = alpaka::getValidWorkDiv(
+        cfgExtent,
+        devAcc,
+        initBufferKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        dx,
+        dy);
+
+    // Create queues
+    using QueueProperty = alpaka::NonBlocking;
+    using QueueAcc = alpaka::Queue<Acc, QueueProperty>;
+    QueueAcc dumpQueue{devAcc};
+    QueueAcc computeQueue{devAcc};
+
+    alpaka::memcpy(computeQueue, diffusivityBufAcc, diffusivityBufHost);
+    alpaka::exec<Acc>(
+        computeQueue,
+        workDivExtent,
+        initBufferKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        dx,
+        dy);
+
+    // Appropriate chunk size to split your problem for your Acc, a chunk never spans several members
+    constexpr Idx xSize = 16u;
+    constexpr Idx ySize = 16u;
+    constexpr alpaka::Vec<Dim, Idx> chunkSize{1, ySize, xSize};
+    constexpr auto sharedMemSize = (ySize + 2 * haloSize[1]) * (xSize + 2 * haloSize[2]);
+    StencilKernel<sharedMemSize, Stencil> stencilKernel;
+
+    constexpr alpaka::Vec<Dim, Idx> numChunks{
+        numMembers,
+        alpaka::core::divCeil(numNodes[1], chunkSize[1]),
+        alpaka::core::divCeil(numNodes[2], chunkSize[2]),
+    };
+
+    assert(
+        numNodes[1] % chunkSize[1] == 0 && numNodes[2] % chunkSize[2] == 0
+        && "Domain must be divisible by chunk size");
+
+    // Get max threads that can be run in a block for this kernel
+    auto const kernelFunctionAttributes = alpaka::getFunctionAttributes<Acc>(
+        devAcc,
+        stencilKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        alpaka::experimental::getMdSpan(uNextBufAcc),
+        alpaka::getPtrNative(diffusivityBufAcc),
+        chunkSize,
+        haloSize,
+        dx,
+        dy,
+        dt);
+    auto const maxThreadsPerBlock = kernelFunctionAttributes.maxThreadsPerBlock;
+
+    auto const threadsPerBlock
+        = maxThreadsPerBlock < chunkSize.prod() ? alpaka::Vec<Dim, Idx>{1, maxThreadsPerBlock, 1} : chunkSize;
+
+    alpaka::WorkDivMembers<Dim, Idx> workDivCore{numChunks, threadsPerBlock, elemPerThread};
+
+    // Timing start
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Simulate
+    for(uint32_t step = 1; step <= numTimeSteps; ++step)
+    {
+        // Compute next values of all members
+        alpaka::exec<Acc>(
+            computeQueue,
+            workDivCore,
+            stencilKernel,
+            alpaka::experimental::getMdSpan(uCurrBufAcc),
+            alpaka::experimental::getMdSpan(uNextBufAcc),
+            alpaka::getPtrNative(diffusivityBufAcc),
+            chunkSize,
+            haloSize,
+            dx,
+            dy,
+            dt);
+
+        // Apply boundaries
+        applyBoundaries<Acc>(
+            workDivExtent,
+            computeQueue,
+            alpaka::experimental::getMdSpan(uNextBufAcc),
+            alpaka::getPtrNative(diffusivityBufAcc),
+            haloSize,
+            step,
+            dx,
+            dy,
+            dt);
+
+        // Swap next and curr (shallow copy)
+        std::swap(uNextBufAcc, uCurrBufAcc);
+    }
+    alpaka::wait(computeQueue);
+
+    // Timing end
+    if(enableTiming)
+    {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsedTime = endTime - startTime;
+        std::cout << "Simulation of " << numMembers << " members took " << elapsedTime.count() << " seconds."
+                  << std::endl;
+    }
+
+    // Copy device -> host
+    alpaka::memcpy(dumpQueue, uBufHost, uCurrBufAcc);
+    alpaka::wait(dumpQueue);
+
+    // Validate every member against the analytical solution with its diffusivity
+    bool allResultsCorrect = true;
+    for(Idx member = 0; member < numMembers; ++member)
+    {
+        auto const [resultIsCorrect, maxError]
+            = validateEnsembleMember(uBufHost, member, dx, dy, diffusivityHost[member] * tMax);
+        std::cout << "Member " << member << " with diffusivity " << diffusivityHost[member] << ": max error "
+                  << maxError << (resultIsCorrect ? "" : " (incorrect)") << std::endl;
+        allResultsCorrect = allResultsCorrect && resultIsCorrect;
+    }
+
+    if(allResultsCorrect)
+    {
+        std::cout << "Execution results correct!" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        std::cout << "Execution results incorrect (the grid resolution may be too low)" << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    // Execute the example for the accelerator selected with --accelerator <name> or HEAT_EQUATION_ACCELERATOR,
+    // otherwise once for each enabled accelerator, see AcceleratorSelection.hpp. --list-accelerators prints the
+    // enabled accelerators and their devices.
+    // If you would like to always execute it for a single accelerator only you can use
+    // the following code.
+    //  \code{.cpp}
+    //  auto tag = alpaka::TagCpuSerial{};
+    //  return example(tag);
+    //  \endcode
+    //
+    // valid tags:
+    //   TagCpuSerial, TagGpuHipRt, TagGpuCudaRt, TagCpuOmp2Blocks,
+    //   TagCpuTbbBlocks, TagCpuOmp2Threads, TagCpuSycl, TagCpuTbbBlocks,
+    //   TagCpuThreads, TagFpgaSyclIntel, TagGenericSycl, TagGpuSyclIntel
+    return executeForSelectedAccTag(argc, argv, [=](auto const& tag) { return example(tag); });
+}
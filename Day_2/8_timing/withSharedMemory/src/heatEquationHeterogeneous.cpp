@@ -0,0 +1,262 @@
+/* Copyright 2024 Benjamin Worpitz, Matthias Werner, Jakob Krude, Sergei
+ * Bastrakov, Bernhard Manfred Gruber, Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#include "AcceleratorSelection.hpp"
+#include "DomainPart.hpp"
+#include "Stencil.hpp"
+#include "analyticalSolution.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <thread>
+
+#ifdef ENABLE_TIMING
+constexpr bool enableTiming = true;
+#else
+constexpr bool enableTiming = false;
+#endif
+
+//! Chunk rows of the upper part before the first rebalancing, 0 splits the domain in half. An uneven initial split is
+//! moved by the rebalancing even between two equal accelerators.
+#ifdef HETEROGENEOUS_INITIAL_CHUNK_ROWS
+constexpr uint32_t initialChunkRowsFirst = HETEROGENEOUS_INITIAL_CHUNK_ROWS;
+#else
+constexpr uint32_t initialChunkRowsFirst = 0;
+#endif
+
+//! Finite-difference stencil of the Laplacian
+#if defined(STENCIL_NINE_POINT)
+using Stencil = NinePointStencil;
+#elif defined(STENCIL_THIRTEEN_POINT)
+using Stencil = ThirteenPointStencil;
+#else
+using Stencil = FivePointStencil;
+#endif
+
+//! 2D heat equation example with the explicit scheme on two accelerators at once
+//!
+//! The domain is split along y into two DomainParts, the upper one runs on the first and the lower one on the second
+//! accelerator, both advance concurrently in their own queues. After every step the haloSize[0] rows next to the
+//! interface are exchanged through host memory. The time each part needs for its steps is measured, every
+//! rebalanceInterval steps the split moves to the ratio of the measured throughputs, in units of chunk rows.
+template<typename TAccTagFirst, typename TAccTagSecond>
+auto example(TAccTagFirst const&, TAccTagSecond const&) -> int
+{
+    // Set Dim and Idx type
+    using Dim = alpaka::DimInt<2u>;
+    using Idx = uint32_t;
+
+    // Define the accelerators
+    using AccFirst = alpaka::TagToAcc<TAccTagFirst, Dim, Idx>;
+    using AccSecond = alpaka::TagToAcc<TAccTagSecond, Dim, Idx>;
+    std::cout << "Using alpaka accelerators: " << alpaka::getAccName<AccFirst>() << " and "
+              << alpaka::getAccName<AccSecond>() << std::endl;
+
+    // Select specific devices
+    auto const platformHost = alpaka::PlatformCpu{};
+    auto const devHost = alpaka::getDevByIdx(platformHost, 0);
+    auto const devFirst = alpaka::getDevByIdx(alpaka::Platform<AccFirst>{}, 0);
+    auto const devSecond = alpaka::getDevByIdx(alpaka::Platform<AccSecond>{}, 0);
+
+    // simulation defines
+    // {Y, X}
+    constexpr Idx numNodesPerDim = Stencil::radius == 1 ? 64 : 32;
+    constexpr alpaka::Vec<Dim, Idx> numNodes{numNodesPerDim, numNodesPerDim};
+    constexpr alpaka::Vec<Dim, Idx> haloSize{Stencil::radius, Stencil::radius};
+    constexpr alpaka::Vec<Dim, Idx> extent = numNodes + haloSize + haloSize;
+
+    constexpr uint32_t numTimeSteps = 4000;
+    constexpr double tMax = 0.1;
+
+    // x, y in [0, 1], t in [0, tMax]
+    constexpr double dx = 1.0 / static_cast<double>(extent[1] - 1);
+    constexpr double dy = 1.0 / static_cast<double>(extent[0] - 1);
+    constexpr double dt = tMax / static_cast<double>(numTimeSteps);
+
+    // The split is adjusted to the measured throughputs every rebalanceInterval steps
+    constexpr uint32_t rebalanceInterval = 500;
+
+    // Check the stability condition, forward Euler requires dt * spectral radius <= 2
+    double const r = Stencil::spectralRadius() / 2.0 * dt * (1.0 / (dx * dx) + 1.0 / (dy * dy));
+    if(r > 1.)
+    {
+        std::cerr << "Stability condition check failed: dt * spectral radius / 2 = " << r
+                  << ", it is required to be <= 1\n";
+        return EXIT_FAILURE;
+    }
+
+    // Appropriate chunk size to split your problem for your Acc, the split moves in units of chunk rows
+    constexpr Idx xSize = 16u;
+    constexpr Idx ySize = 8u;
+    constexpr alpaka::Vec<Dim, Idx> chunkSize{ySize, xSize};
+    constexpr auto sharedMemSize = (ySize + 2 * haloSize[0]) * (xSize + 2 * haloSize[1]);
+    constexpr Idx numChunkRows = numNodes[0] / chunkSize[0];
+    static_assert(initialChunkRowsFirst < numChunkRows, "Both parts need at least one chunk row");
+
+    assert(
+        numNodes[0] % chunkSize[0] == 0 && numNodes[1] % chunkSize[1] == 0
+        && "Domain must be divisible by chunk size");
+
+    // The whole grid in host memory holds the initial values and collects the parts when the split changes
+    auto uBufHost = alpaka::allocBuf<double, Idx>(devHost, extent);
+    double* const uHost = alpaka::getPtrNative(uBufHost);
+    for(Idx j = 0; j < extent[0]; ++j)
+    {
+        for(Idx i = 0; i < extent[1]; ++i)
+            uHost[j * extent[1] + i] = analyticalSolution(i * dx, j * dy, 0.0);
+    }
+
+    // Halo rows on their way between the parts
+    auto rowsToSecondHost = alpaka::allocBuf<double, Idx>(devHost, haloSize[0] * extent[1]);
+    auto rowsToFirstHost = alpaka::allocBuf<double, Idx>(devHost, haloSize[0] * extent[1]);
+
+    // Create queues
+    using QueueProperty = alpaka::NonBlocking;
+    alpaka::Queue<AccFirst, QueueProperty> queueFirst{devFirst};
+    alpaka::Queue<AccSecond, QueueProperty> queueSecond{devSecond};
+
+    std::optional<DomainPart<AccFirst, sharedMemSize, Stencil>> partFirst;
+    std::optional<DomainPart<AccSecond, sharedMemSize, Stencil>> partSecond;
+
+    // Split the grid in host memory after chunkRowsFirst chunk rows
+    auto distribute = [&](Idx const chunkRowsFirst)
+    {
+        Idx const numRowsFirst = chunkRowsFirst * chunkSize[0];
+        partFirst.emplace(devFirst, 0, numRowsFirst, numNodes[1], chunkSize, haloSize, dx, dy, dt);
+        partSecond.emplace(
+            devSecond,
+            numRowsFirst,
+            numNodes[0] - numRowsFirst,
+            numNodes[1],
+            chunkSize,
+            haloSize,
+            dx,
+            dy,
+            dt);
+        partFirst->scatter(queueFirst, uBufHost);
+        partSecond->scatter(queueSecond, uBufHost);
+    };
+
+    // Collect the parts in the grid in host memory, each part contributes its outer halo rows
+    auto collect = [&]()
+    {
+        partFirst->gather(queueFirst, uBufHost, 0, haloSize[0] + partFirst->numRows());
+        partSecond->gather(queueSecond, uBufHost, haloSize[0], 2 * haloSize[0] + partSecond->numRows());
+    };
+
+    Idx chunkRowsFirst = initialChunkRowsFirst == 0 ? numChunkRows / 2 : initialChunkRowsFirst;
+    distribute(chunkRowsFirst);
+
+    // Time from the launch of a step until its queue finished, summed over the steps since the last rebalancing
+    double busyTimeFirst = 0.0;
+    double busyTimeSecond = 0.0;
+    double throughputFirst = 0.0;
+    double throughputSecond = 0.0;
+    uint32_t numRebalances = 0;
+
+    // Timing start
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    // Simulate
+    for(uint32_t step = 1; step <= numTimeSteps; ++step)
+    {
+        // Compute next values in both parts concurrently
+        auto const launchFirst = std::chrono::high_resolution_clock::now();
+        partFirst->step(queueFirst, step * dt);
+        auto const launchSecond = std::chrono::high_resolution_clock::now();
+        partSecond->step(queueSecond, step * dt);
+
+        // Each queue is waited for in a thread of its own, which sleeps until the queue finished and then takes the
+        // time, so the measured time of a part neither waits for the other part nor competes with a spinning host
+        std::thread waitFirst{
+            [&]()
+            {
+                alpaka::wait(queueFirst);
+                busyTimeFirst
+                    += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - launchFirst).count();
+            }};
+        alpaka::wait(queueSecond);
+        busyTimeSecond
+            += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - launchSecond).count();
+        waitFirst.join();
+
+        // Exchange the rows next to the interface, the last core rows of the first part go to the upper halo of the
+        // second part and the first core rows of the second part go to the lower halo of the first part
+        partFirst->packRows(queueFirst, partFirst->numRows(), rowsToSecondHost);
+        partSecond->packRows(queueSecond, haloSize[0], rowsToFirstHost);
+        alpaka::wait(queueFirst);
+        alpaka::wait(queueSecond);
+        partFirst->unpackRows(queueFirst, rowsToFirstHost, haloSize[0] + partFirst->numRows());
+        partSecond->unpackRows(queueSecond, rowsToSecondHost, 0);
+
+        // Move the split to the ratio of the measured throughputs
+        if(step % rebalanceInterval == 0 && step < numTimeSteps)
+        {
+            throughputFirst = partFirst->numRows() * rebalanceInterval / busyTimeFirst;
+            throughputSecond = partSecond->numRows() * rebalanceInterval / busyTimeSecond;
+            busyTimeFirst = 0.0;
+            busyTimeSecond = 0.0;
+
+            Idx const balancedChunkRows = balanceChunkRows(numChunkRows, throughputFirst, throughputSecond);
+            if(balancedChunkRows != chunkRowsFirst)
+            {
+                collect();
+                chunkRowsFirst = balancedChunkRows;
+                distribute(chunkRowsFirst);
+                ++numRebalances;
+            }
+        }
+    }
+    alpaka::wait(queueFirst);
+    alpaka::wait(queueSecond);
+
+    // Timing end
+    if(enableTiming)
+    {
+        auto endTime = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> elapsedTime = endTime - startTime;
+        std::cout << "Simulation took " << elapsedTime.count() << " seconds." << std::endl;
+    }
+    std::cout << "Measured throughputs of " << throughputFirst << " and " << throughputSecond
+              << " rows per second, final split " << partFirst->numRows() << " : " << partSecond->numRows()
+              << " rows after " << numRebalances << " changes" << std::endl;
+
+    // Copy device -> host
+    collect();
+
+    // Validate
+    auto const [resultIsCorrect, maxError] = validateSolution(uBufHost, dx, dy, tMax);
+
+    if(resultIsCorrect)
+    {
+        std::cout << "Execution results correct!" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        std::cout << "Execution results incorrect: Max error = " << maxError << " (the grid resolution may be too low)"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    // Split the domain between the pair of accelerators selected with --accelerator <first>,<second> or
+    // HEAT_EQUATION_ACCELERATOR, for example CpuOmp2Blocks,CpuThreads, otherwise between the first and the last
+    // enabled accelerator, see AcceleratorSelection.hpp.
+    // If you would like to select the accelerators in the code you can use the following code.
+    //  \code{.cpp}
+    //  return example(alpaka::TagCpuOmp2Blocks{}, alpaka::TagCpuThreads{});
+    //  \endcode
+    return executeForSelectedAccTagPair(
+        argc,
+        argv,
+        [=](auto const& tagFirst, auto const& tagSecond) { return example(tagFirst, tagSecond); });
+}
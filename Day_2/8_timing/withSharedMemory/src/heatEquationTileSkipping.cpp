@@ -0,0 +1,179 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#include "AcceleratorSelection.hpp"
+#include "StencilKernel.hpp"
+#include "TileActivity.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+
+//! Check of the tile skipping on a problem with localized activity
+//!
+//! A narrow Gaussian in the centre of the domain diffuses between boundary values of zero, so the tiles away from it
+//! never change by more than the epsilon of the TileActivity. The same steps run once with the TileActivity and once
+//! with the StencilKernel on every tile. The check requires that tiles were skipped and that both results agree within
+//! a tolerance, which covers the changes below epsilon the skipped tiles miss.
+template<typename TAccTag>
+auto example(TAccTag const&) -> int
+{
+    // Set Dim and Idx type
+    using Dim = alpaka::DimInt<2u>;
+    using Idx = uint32_t;
+
+    // Define the accelerator
+    using Acc = alpaka::TagToAcc<TAccTag, Dim, Idx>;
+    std::cout << "Using alpaka accelerator: " << alpaka::getAccName<Acc>() << std::endl;
+
+    // Select specific devices
+    auto const platformHost = alpaka::PlatformCpu{};
+    auto const devHost = alpaka::getDevByIdx(platformHost, 0);
+    auto const platformAcc = alpaka::Platform<Acc>{};
+    // get suitable device for this Acc
+    auto const devAcc = alpaka::getDevByIdx(platformAcc, 0);
+
+    // simulation defines
+    // {Y, X}
+    constexpr alpaka::Vec<Dim, Idx> numNodes{256, 256};
+    constexpr alpaka::Vec<Dim, Idx> haloSize{1, 1};
+    constexpr alpaka::Vec<Dim, Idx> extent = numNodes + haloSize + haloSize;
+
+    constexpr uint32_t numTimeSteps = 200;
+
+    // x, y in [0, 1], the time step is a fifth of dx^2, below the stability limit of a quarter
+    constexpr double dx = 1.0 / static_cast<double>(extent[1] - 1);
+    constexpr double dy = 1.0 / static_cast<double>(extent[0] - 1);
+    constexpr double dt = 0.2 * dx * dx;
+
+    // Width of the Gaussian, the solution spreads over a few more cells until the end
+    constexpr double sigma = 4.0 * dx;
+    // Largest difference between the sparse and the dense update, the skipped tiles miss changes below the epsilon of
+    // the TileActivity in every step
+    constexpr double tolerance = 1e-9;
+
+    // Initialize host-buffer
+    auto uBufHost = alpaka::allocBuf<double, Idx>(devHost, extent);
+    auto uSparseBufHost = alpaka::allocBuf<double, Idx>(devHost, extent);
+    double* const uHost = alpaka::getPtrNative(uBufHost);
+    for(Idx j = 0; j < extent[0]; ++j)
+    {
+        for(Idx i = 0; i < extent[1]; ++i)
+        {
+            double const x = i * dx - 0.5;
+            double const y = j * dy - 0.5;
+            uHost[j * extent[1] + i] = std::exp(-(x * x + y * y) / (2.0 * sigma * sigma));
+        }
+    }
+
+    // Accelerator buffers of the dense and of the sparse update, both start with the same values in both grids, the
+    // skipped tiles are never written
+    auto uCurrBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+    auto uNextBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+    auto uSparseCurrBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+    auto uSparseNextBufAcc = alpaka::allocBuf<double, Idx>(devAcc, extent);
+
+    // Create queues
+    using QueueProperty = alpaka::NonBlocking;
+    using QueueAcc = alpaka::Queue<Acc, QueueProperty>;
+    QueueAcc computeQueue{devAcc};
+
+    alpaka::memcpy(computeQueue, uCurrBufAcc, uBufHost);
+    alpaka::memcpy(computeQueue, uNextBufAcc, uBufHost);
+    alpaka::memcpy(computeQueue, uSparseCurrBufAcc, uBufHost);
+    alpaka::memcpy(computeQueue, uSparseNextBufAcc, uBufHost);
+
+    // Appropriate chunk size to split your problem for your Acc, a chunk is a tile of the TileActivity
+    constexpr Idx xSize = 16u;
+    constexpr Idx ySize = 16u;
+    constexpr alpaka::Vec<Dim, Idx> chunkSize{ySize, xSize};
+    constexpr auto sharedMemSize = (ySize + 2 * haloSize[0]) * (xSize + 2 * haloSize[1]);
+    StencilKernel<sharedMemSize> stencilKernel;
+
+    constexpr alpaka::Vec<Dim, Idx> numChunks{
+        alpaka::core::divCeil(numNodes[0], chunkSize[0]),
+        alpaka::core::divCeil(numNodes[1], chunkSize[1]),
+    };
+
+    // Get max threads that can be run in a block for this kernel
+    auto const kernelFunctionAttributes = alpaka::getFunctionAttributes<Acc>(
+        devAcc,
+        stencilKernel,
+        alpaka::experimental::getMdSpan(uCurrBufAcc),
+        alpaka::experimental::getMdSpan(uNextBufAcc),
+        chunkSize,
+        haloSize,
+        dx,
+        dy,
+        dt);
+    auto const maxThreadsPerBlock = kernelFunctionAttributes.maxThreadsPerBlock;
+
+    auto const threadsPerBlock
+        = maxThreadsPerBlock < chunkSize.prod() ? alpaka::Vec<Dim, Idx>{maxThreadsPerBlock, 1} : chunkSize;
+
+    constexpr alpaka::Vec<Dim, Idx> elemPerThread{1, 1};
+    alpaka::WorkDivMembers<Dim, Idx> workDivCore{numChunks, threadsPerBlock, elemPerThread};
+
+    TileActivity<Acc, sharedMemSize> tileActivity{devAcc, workDivCore, numChunks, chunkSize, haloSize, dx, dy, dt};
+
+    // Simulate, the boundary values stay zero
+    for(uint32_t step = 1; step <= numTimeSteps; ++step)
+    {
+        alpaka::exec<Acc>(
+            computeQueue,
+            workDivCore,
+            stencilKernel,
+            alpaka::experimental::getMdSpan(uCurrBufAcc),
+            alpaka::experimental::getMdSpan(uNextBufAcc),
+            chunkSize,
+            haloSize,
+            dx,
+            dy,
+            dt);
+        tileActivity.step(computeQueue, uSparseCurrBufAcc, uSparseNextBufAcc);
+
+        // Swap next and curr (shallow copy)
+        std::swap(uNextBufAcc, uCurrBufAcc);
+        std::swap(uSparseNextBufAcc, uSparseCurrBufAcc);
+    }
+    auto const numTileUpdates = tileActivity.numTileUpdates(computeQueue);
+
+    // Copy device -> host
+    alpaka::memcpy(computeQueue, uBufHost, uCurrBufAcc);
+    alpaka::memcpy(computeQueue, uSparseBufHost, uSparseCurrBufAcc);
+    alpaka::wait(computeQueue);
+
+    // Compare the sparse to the dense update
+    double const* const uSparseHost = alpaka::getPtrNative(uSparseBufHost);
+    double maxDifference = 0.0;
+    for(Idx i = 0; i < extent.prod(); ++i)
+        maxDifference = std::max(maxDifference, std::abs(uSparseHost[i] - uHost[i]));
+
+    Idx const numTiles = numTimeSteps * numChunks.prod();
+    std::cout << "Updated " << numTileUpdates << " of " << numTiles
+              << " tiles, max difference to the update of all tiles = " << maxDifference << std::endl;
+
+    if(numTileUpdates < numTiles && maxDifference < tolerance)
+    {
+        std::cout << "Execution results correct!" << std::endl;
+        return EXIT_SUCCESS;
+    }
+    else
+    {
+        std::cout << "Execution results incorrect: " << (numTileUpdates < numTiles ? "" : "no tile was skipped, ")
+                  << "max difference = " << maxDifference << std::endl;
+        return EXIT_FAILURE;
+    }
+}
+
+auto main(int argc, char* argv[]) -> int
+{
+    // Execute the check for the accelerator selected with --accelerator <name> or HEAT_EQUATION_ACCELERATOR,
+    // otherwise once for each enabled accelerator, see AcceleratorSelection.hpp.
+    return executeForSelectedAccTag(argc, argv, [=](auto const& tag) { return example(tag); });
+}
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <alpaka/extent/Traits.hpp>
+#include <alpaka/mem/view/Traits.hpp>
 
 #include <pngwriter.h>
 
@@ -27,11 +28,15 @@ auto writeImage(uint32_t const currentStep, T_Buffer const& buffer) -> void
     pngwriter png{static_cast<int>(extents[1]), static_cast<int>(extents[0]), 0, filename.c_str()};
     png.setcompressionlevel(9);
 
+    // the rows may be padded
+    double const* const data = alpaka::getPtrNative(buffer);
+    auto const rowPitch = alpaka::getPitchesInBytes(buffer)[0] / sizeof(double);
+
     for(uint32_t y = 0; y < extents[0]; ++y)
     {
         for(uint32_t x = 0; x < extents[1]; ++x)
         {
-            auto p = buffer.data()[y * extents[1] + x];
+            auto p = data[y * rowPitch + x];
             png.plot(
                 x + 1,
                 extents[0] - y,
@@ -0,0 +1,212 @@
+/* Copyright 2024 Tapish Narwal
+ * SPDX-License-Identifier: ISC
+ */
+
+#pragma once
+
+#include "BandwidthProbeKernels.hpp"
+
+#include <alpaka/alpaka.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+
+//! Attainable bandwidth of a device in bytes per second
+struct AttainableBandwidth
+{
+    double copy = 0.0;
+    double scale = 0.0;
+    double triad = 0.0;
+    //! alpaka::memcpy from the device into a host buffer, the direction of the dump copies
+    double deviceToHost = 0.0;
+
+    //! Best of the STREAM kernels, the bound of a kernel that streams through the memory of the device
+    auto peak() const -> double
+    {
+        return std::max({copy, scale, triad});
+    }
+};
+
+//! Mean time of numLaunches calls of launch, which enqueues the work into the queue
+template<typename TQueue, typename TLaunch>
+auto timeLaunches(TQueue& queue, uint32_t const numLaunches, TLaunch&& launch) -> double
+{
+    // the first launch warms up the caches and the runtime
+    launch();
+    alpaka::wait(queue);
+    auto const start = std::chrono::high_resolution_clock::now();
+    for(uint32_t i = 0; i < numLaunches; ++i)
+        launch();
+    alpaka::wait(queue);
+    std::chrono::duration<double> const elapsed = std::chrono::high_resolution_clock::now() - start;
+    return elapsed.count() / numLaunches;
+}
+
+//! STREAM-style probe of the attainable bandwidth of the device of an accelerator
+//!
+//! Copy, scale and triad run on arrays of numElements elements. The default arrays are large enough to miss all
+//! caches, arrays of the size of a grid measure the bandwidth of the working set of a kernel on that grid, from the
+//! caches if the grid fits into them. Like STREAM the copy and the scale move 16 bytes per element, the triad 24
+//! bytes, and the best of a few runs counts. The device to host copy moves 8 bytes per element into a pageable host
+//! buffer like the dump copies.
+//!
+//! \tparam TAcc accelerator type
+template<typename TAcc>
+class BandwidthProbe
+{
+public:
+    using Idx = alpaka::Idx<TAcc>;
+    using Dim = alpaka::Dim<TAcc>;
+    using DevAcc = alpaka::Dev<TAcc>;
+    using Vec = alpaka::Vec<Dim, Idx>;
+
+    static constexpr uint32_t numRuns = 5u;
+    //! elements of the arrays that miss all caches
+    static constexpr Idx numElementsBeyondCaches = Idx{1} << 23;
+
+    //! \param devAcc device of the accelerator
+    //! \param numElements elements of each array
+    explicit BandwidthProbe(DevAcc const& devAcc, Idx const numElements = numElementsBeyondCaches)
+    {
+        auto const devHost = alpaka::getDevByIdx(alpaka::PlatformCpu{}, 0);
+        alpaka::Queue<TAcc, alpaka::Blocking> queue{devAcc};
+        auto a = alpaka::allocBuf<double, Idx>(devAcc, numElements);
+        auto b = alpaka::allocBuf<double, Idx>(devAcc, numElements);
+        auto c = alpaka::allocBuf<double, Idx>(devAcc, numElements);
+        auto aHost = alpaka::allocBuf<double, Idx>(devHost, numElements);
+        alpaka::memset(queue, a, 0u);
+        alpaka::memset(queue, b, 0u);
+        alpaka::memset(queue, c, 0u);
+
+        double* const aPtr = alpaka::getPtrNative(a);
+        double const* const bPtr = alpaka::getPtrNative(b);
+        double const* const cPtr = alpaka::getPtrNative(c);
+        double const scalar = 3.0;
+
+        // every thread handles a few elements, the triad needs the most registers
+        auto extent = Vec::ones();
+        extent[Dim::value - 1u] = std::max(numElements / Idx{16u}, Idx{1u});
+        alpaka::KernelCfg<TAcc> const cfg{extent, Vec::ones()};
+        auto const workDiv
+            = alpaka::getValidWorkDiv(cfg, devAcc, TriadKernel{}, aPtr, bPtr, cPtr, scalar, numElements);
+
+        auto const copy = [&]() { alpaka::exec<TAcc>(queue, workDiv, CopyKernel{}, aPtr, bPtr, numElements); };
+        auto const scale
+            = [&]() { alpaka::exec<TAcc>(queue, workDiv, ScaleKernel{}, aPtr, bPtr, scalar, numElements); };
+        auto const triad
+            = [&]() { alpaka::exec<TAcc>(queue, workDiv, TriadKernel{}, aPtr, bPtr, cPtr, scalar, numElements); };
+        auto const deviceToHost = [&]() { alpaka::memcpy(queue, aHost, a); };
+
+        double const numBytes = static_cast<double>(sizeof(double)) * numElements;
+        m_bandwidth.copy = 2.0 * numBytes / bestTime(queue, copy);
+        m_bandwidth.scale = 2.0 * numBytes / bestTime(queue, scale);
+        m_bandwidth.triad = 3.0 * numBytes / bestTime(queue, triad);
+        m_bandwidth.deviceToHost = numBytes / bestTime(queue, deviceToHost);
+    }
+
+    auto bandwidth() const -> AttainableBandwidth const&
+    {
+        return m_bandwidth;
+    }
+
+private:
+    //! Shortest of numRuns runs after a first run that touches the memory
+    template<typename TQueue, typename TRun>
+    static auto bestTime(TQueue& queue, TRun&& run) -> double
+    {
+        run();
+        alpaka::wait(queue);
+        double best = 0.0;
+        for(uint32_t i = 0; i < numRuns; ++i)
+        {
+            auto const start = std::chrono::high_resolution_clock::now();
+            run();
+            alpaka::wait(queue);
+            std::chrono::duration<double> const elapsed = std::chrono::high_resolution_clock::now() - start;
+            if(i == 0 || elapsed.count() < best)
+                best = elapsed.count();
+        }
+        return best;
+    }
+
+    AttainableBandwidth m_bandwidth;
+};
+
+//! Attainable bandwidth of the device of an accelerator, the BandwidthProbe runs once per accelerator, device and size
+//! of the arrays
+//!
+//! The results are kept for the rest of the process. Only if HEAT_EQUATION_BANDWIDTH_CACHE names a cache file they are
+//! also kept in that file, so later runs skip the probe. Delete the file to probe again, e.g. after a change of the
+//! machine.
+//!
+//! \param devAcc device of the accelerator
+//! \param numElements elements of each array of the probe, e.g. the cells of a grid, see BandwidthProbe
+template<typename TAcc>
+auto attainableBandwidth(
+    alpaka::Dev<TAcc> const& devAcc,
+    alpaka::Idx<TAcc> const numElements = BandwidthProbe<TAcc>::numElementsBeyondCaches) -> AttainableBandwidth
+{
+    static std::map<std::string, AttainableBandwidth> probed;
+    std::string const key = alpaka::getAccName<TAcc>() + " on " + alpaka::getName(devAcc) + " with arrays of "
+                            + std::to_string(numElements) + " elements";
+    if(auto const known = probed.find(key); known != probed.end())
+        return known->second;
+
+    char const* const path = std::getenv("HEAT_EQUATION_BANDWIDTH_CACHE");
+
+    // a line per accelerator, device and size: the key, a tab and the bandwidths in bytes per second
+    if(path != nullptr)
+    {
+        std::ifstream cacheIn{path};
+        std::string line;
+        while(std::getline(cacheIn, line))
+        {
+            auto const tab = line.rfind('\t');
+            if(tab == std::string::npos || line.substr(0, tab) != key)
+                continue;
+            AttainableBandwidth cached;
+            std::istringstream values{line.substr(tab + 1)};
+            if(values >> cached.copy >> cached.scale >> cached.triad >> cached.deviceToHost)
+            {
+                std::cout << "Attainable bandwidth of " << key << " read from " << path << std::endl;
+                return probed[key] = cached;
+            }
+        }
+    }
+
+    std::cout << "Probing the attainable bandwidth of " << key << std::endl;
+    auto const bandwidth = BandwidthProbe<TAcc>{devAcc, numElements}.bandwidth();
+    if(path != nullptr)
+    {
+        std::ofstream cacheOut{path, std::ios::app};
+        cacheOut << key << '\t' << bandwidth.copy << ' ' << bandwidth.scale << ' ' << bandwidth.triad << ' '
+                 << bandwidth.deviceToHost << '\n';
+    }
+    return probed[key] = bandwidth;
+}
+
+//! Prints the achieved bandwidth of a kernel or copy and its share of the attainable bandwidth
+//!
+//! \param name name of the kernel or copy
+//! \param numBytes bytes moved by a launch
+//! \param seconds time of a launch
+//! \param attainable attainable bandwidth in bytes per second
+auto reportBandwidthShare(
+    std::string const& name,
+    double const numBytes,
+    double const seconds,
+    double const attainable) -> void
+{
+    auto const precision = std::cout.precision(3);
+    double const achieved = numBytes / seconds;
+    std::cout << "  " << name << ": " << seconds * 1e6 << " us, " << achieved / 1e9 << " GB/s, "
+              << 100.0 * achieved / attainable << " % of attainable bandwidth" << std::endl;
+    std::cout.precision(precision);
+}
@@ -21,6 +21,10 @@
 //! \param dt step in t
 struct BoundaryKernel
 {
+    //! cost per boundary cell for the roofline, the value is only written, see analyticalSolutionFlops
+    static constexpr double bytesPerCell = sizeof(double);
+    static constexpr double flopsPerCell = analyticalSolutionFlops + 3.0;
+
     template<typename TAcc, typename TMdSpan>
     ALPAKA_FN_ACC auto operator()(
         TAcc const& acc,
@@ -21,6 +21,10 @@
 //! \param dy
 struct InitializeBufferKernel
 {
+    //! cost per cell for the roofline, the value is only written, see analyticalSolutionFlops
+    static constexpr double bytesPerCell = sizeof(double);
+    static constexpr double flopsPerCell = analyticalSolutionFlops + 2.0;
+
     template<typename TAcc, typename TMdSpan>
     ALPAKA_FN_ACC auto operator()(TAcc const& acc, TMdSpan bufData, double dx, double dy) const -> void
     {
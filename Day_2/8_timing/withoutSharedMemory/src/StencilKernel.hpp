@@ -27,6 +27,11 @@
 // **************************************************************
 struct StencilKernel
 {
+    //! compulsory traffic per core cell for the roofline, the caches have to provide the neighbours
+    static constexpr double bytesPerCell = 2.0 * sizeof(double);
+    //! five multiplications and four additions, the coefficient of the center is loop-invariant
+    static constexpr double flopsPerCell = 9.0;
+
     template<typename TAcc, typename TMdSpan, typename TDim, typename TIdx>
     ALPAKA_FN_ACC auto operator()(
         TAcc const& acc,
@@ -8,6 +8,10 @@
 
 #include <cmath>
 
+//! Floating point operations of analyticalSolution for the roofline, the exponential and the sines count as one
+//! operation each. The kernels add the scaling of their indices.
+constexpr double analyticalSolutionFlops = 8.0;
+
 //! Exact solution to the test problem at postion (x,y) at time t
 //! u_t(x, y, t) = u_xx(x, t) + u_yy(y, t), x in [0, 1], y in [0, 1], t in [0, T]
 //!
@@ -52,3 +56,11 @@ auto validateSolution(T_Buffer const& buffer, double const dx, double const dy,
     constexpr double errorThreshold = 1e-4;
     return std::make_pair(maxError < errorThreshold, maxError);
 }
+
+//! Cost of validateSolution per core cell for the roofline, the value is read and compared to the analytical solution
+struct ValidationCost
+{
+    static constexpr double bytesPerCell = sizeof(double);
+    //! the scaling of the indices, the difference, its absolute value and the maximum
+    static constexpr double flopsPerCell = analyticalSolutionFlops + 5.0;
+};
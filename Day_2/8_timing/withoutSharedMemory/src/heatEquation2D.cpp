@@ -3,8 +3,11 @@
  * SPDX-License-Identifier: ISC
  */
 
+#include "AcceleratorSelection.hpp"
+#include "BandwidthProbe.hpp"
 #include "BoundaryKernel.hpp"
 #include "InitializeBufferKernel.hpp"
+#include "Roofline.hpp"
 #include "StencilKernel.hpp"
 #include "analyticalSolution.hpp"
 
@@ -13,12 +16,12 @@
 #endif
 
 #include <alpaka/alpaka.hpp>
-#include <alpaka/example/ExecuteForEachAccTag.hpp>
 
 #include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <iostream>
+#include <type_traits>
 
 #ifdef ENABLE_TIMING
 constexpr bool enableTiming = true;
@@ -26,6 +29,14 @@ constexpr bool enableTiming = true;
 constexpr bool enableTiming = false;
 #endif
 
+#ifdef ENABLE_ROOFLINE
+constexpr bool roofline = true;
+#else
+constexpr bool roofline = false;
+#endif
+
+static_assert(!roofline || enableTiming, "The roofline is only reported by the timing build");
+
 //! Each kernel computes the next step for one point.
 //! Therefore the number of threads should be equal to numNodesX.
 //! Every time step the kernel will be executed numNodesX-times
@@ -227,6 +238,141 @@ auto example(TAccTag const&) -> int
     // Validate
     auto const [resultIsCorrect, maxError] = validateSolution(uBufHost, dx, dy, tMax);
 
+    // Share of the attainable bandwidth of the stencil, the boundary pass and the dump copies, every one is timed on
+    // its own once the results are copied and validated. The bandwidth is probed with arrays of the size of the grid,
+    // so the kernels and the probe share the level of the memory hierarchy, the caches of CPUs for the small grid. The
+    // probe runs once per process, see attainableBandwidth.
+    constexpr double numCoreCells = static_cast<double>(numNodes.prod());
+    constexpr double numBoundaryCells = static_cast<double>(extent.prod() - numNodes.prod());
+    if constexpr(enableTiming)
+    {
+        constexpr uint32_t numBandwidthLaunches = 20;
+        auto const attainable = attainableBandwidth<Acc>(devAcc, extent.prod());
+        std::cout << "Attainable bandwidth with arrays of the grid size (" << extent.prod() << " elements): copy "
+                  << attainable.copy / 1e9 << " GB/s, scale " << attainable.scale / 1e9 << " GB/s, triad "
+                  << attainable.triad / 1e9 << " GB/s, device to host " << attainable.deviceToHost / 1e9 << " GB/s"
+                  << std::endl;
+
+        double const stencilSeconds = timeLaunches(
+            computeQueue,
+            numBandwidthLaunches,
+            [&]()
+            {
+                alpaka::exec<Acc>(
+                    computeQueue,
+                    workDivCore,
+                    stencilKernel,
+                    alpaka::experimental::getMdSpan(uCurrBufAcc),
+                    alpaka::experimental::getMdSpan(uNextBufAcc),
+                    chunkSize,
+                    haloSize,
+                    dx,
+                    dy,
+                    dt);
+            });
+        double const boundarySeconds = timeLaunches(
+            computeQueue,
+            numBandwidthLaunches,
+            [&]()
+            {
+                applyBoundaries<Acc>(
+                    workDivExtent,
+                    computeQueue,
+                    alpaka::experimental::getMdSpan(uNextBufAcc),
+                    numTimeSteps,
+                    dx,
+                    dy,
+                    dt);
+            });
+        double const dumpSeconds = timeLaunches(
+            dumpQueue,
+            numBandwidthLaunches,
+            [&]() { alpaka::memcpy(dumpQueue, uBufHost, uCurrBufAcc); });
+
+        reportBandwidthShare(
+            "StencilKernel",
+            StencilKernel::bytesPerCell * numCoreCells,
+            stencilSeconds,
+            attainable.peak());
+        reportBandwidthShare(
+            "BoundaryKernel",
+            BoundaryKernel::bytesPerCell * numBoundaryCells,
+            boundarySeconds,
+            attainable.peak());
+        // the copy from a CPU device into host memory reads and writes the same memory like the STREAM copy, the
+        // copy from another device is bound by the transfer to the host
+        constexpr bool hostDevice = std::is_same_v<alpaka::Dev<Acc>, alpaka::DevCpu>;
+        reportBandwidthShare(
+            "copy to host",
+            (hostDevice ? 2.0 : 1.0) * static_cast<double>(sizeof(double) * extent.prod()),
+            dumpSeconds,
+            hostDevice ? attainable.copy : attainable.deviceToHost);
+    }
+
+    // Roofline of the kernels, every kernel is timed on its own once the results are copied and validated
+    if constexpr(roofline)
+    {
+        Roofline<Acc> kernelRoofline{devAcc, extent.prod()};
+        kernelRoofline.measure(
+            computeQueue,
+            "InitializeBufferKernel",
+            kernelCost<InitializeBufferKernel>(),
+            static_cast<double>(extent.prod()),
+            [&]()
+            {
+                alpaka::exec<Acc>(
+                    computeQueue,
+                    workDivExtent,
+                    initBufferKernel,
+                    alpaka::experimental::getMdSpan(uCurrBufAcc),
+                    dx,
+                    dy);
+            });
+        kernelRoofline.measure(
+            computeQueue,
+            "StencilKernel",
+            kernelCost<StencilKernel>(),
+            numCoreCells,
+            [&]()
+            {
+                alpaka::exec<Acc>(
+                    computeQueue,
+                    workDivCore,
+                    stencilKernel,
+                    alpaka::experimental::getMdSpan(uCurrBufAcc),
+                    alpaka::experimental::getMdSpan(uNextBufAcc),
+                    chunkSize,
+                    haloSize,
+                    dx,
+                    dy,
+                    dt);
+            });
+        kernelRoofline.measure(
+            computeQueue,
+            "BoundaryKernel",
+            kernelCost<BoundaryKernel>(),
+            numBoundaryCells,
+            [&]()
+            {
+                applyBoundaries<Acc>(
+                    workDivExtent,
+                    computeQueue,
+                    alpaka::experimental::getMdSpan(uNextBufAcc),
+                    numTimeSteps,
+                    dx,
+                    dy,
+                    dt);
+            });
+        // the volatile store keeps the compiler from dropping the repeated validation
+        volatile double validationError = 0.0;
+        kernelRoofline.measureHost(
+            "validateSolution",
+            kernelCost<ValidationCost>(),
+            numCoreCells,
+            [&]() { validationError = validateSolution(uBufHost, dx, dy, tMax).second; });
+        kernelRoofline.report();
+    }
+
     if(resultIsCorrect)
     {
         std::cout << "Execution results correct!" << std::endl;
@@ -240,10 +386,12 @@ auto example(TAccTag const&) -> int
     }
 }
 
-auto main() -> int
+auto main(int argc, char* argv[]) -> int
 {
-    // Execute the example once for each enabled accelerator.
-    // If you would like to execute it for a single accelerator only you can use
+    // Execute the example for the accelerator selected with --accelerator <name> or HEAT_EQUATION_ACCELERATOR,
+    // otherwise once for each enabled accelerator, see AcceleratorSelection.hpp. --list-accelerators prints the
+    // enabled accelerators and their devices.
+    // If you would like to always execute it for a single accelerator only you can use
     // the following code.
     //  \code{.cpp}
     //  auto tag = alpaka::TagCpuSerial{};
@@ -254,5 +402,5 @@ auto main() -> int
     //   TagCpuSerial, TagGpuHipRt, TagGpuCudaRt, TagCpuOmp2Blocks,
     //   TagCpuTbbBlocks, TagCpuOmp2Threads, TagCpuSycl, TagCpuTbbBlocks,
     //   TagCpuThreads, TagFpgaSyclIntel, TagGenericSycl, TagGpuSyclIntel
-    return alpaka::executeForEachAccTag([=](auto const& tag) { return example(tag); });
+    return executeForSelectedAccTag(argc, argv, [=](auto const& tag) { return example(tag); });
 }